@@ -0,0 +1,385 @@
+// bench/bench_convolucion.c
+// Benchmark de todos los motores de un canal (CPU y OpenCL) sobre la misma imagen:
+//   - N ejecuciones de calentamiento (compilación JIT, caches, pool de buffers) que no se miden
+//   - M repeticiones medidas con reloj monotónico (reloj_ms): clock() suma el tiempo
+//     de CPU de todos los hilos y no sirve para los motores multihilo
+//   - Por motor y fase: min / mediana / p95 / desviación, Mpx/s y GB/s efectivos
+// Con --barrido recorre imágenes sintéticas cuadradas y tamaños de filtro (por
+// defecto 256² .. 16384² y k = 3 .. 31) para ubicar los cruces entre motores.
+// Uso: bench_convolucion [imagen | --ancho W --alto H] [--k K] [--filtro general|gauss|caja]
+//                        [--calentamiento N] [--repeticiones M] [--motores lista]
+//                        [--barrido [--tamanos lista] [--ks lista] [--limite-ms T]]
+//                        [--csv ruta] [--json ruta]
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "aleatorio.h"
+#include "cl_manager.h"
+#include "convolucion_auto.h"
+#include "convolucion_fft.h"
+#include "convolucion_hilos.h"
+#include "convolucion_paralelo.h"
+#include "convolucion_secuencial.h"
+#include "convolucion_simd.h"
+#include "filtro.h"
+#include "image_utils.h"
+#include "reloj.h"
+#include "resultados.h"
+
+// Motor OpenCL: 1 si hizo la convolución (0 = no disponible en este dispositivo)
+typedef int (*MotorConvolucionGPU)(CLManager* mgr, const PlanoImagen* entrada, const PlanoImagen* salida,
+                                   const float* filter, int k_size, TiemposGPU* tiempos);
+
+// convolucion_paralelo_fases con la firma de MotorConvolucionGPU
+static int motor_opencl(CLManager* mgr, const PlanoImagen* entrada, const PlanoImagen* salida,
+                        const float* filter, int k_size, TiemposGPU* tiempos) {
+    convolucion_paralelo_fases(mgr, entrada, salida, filter, k_size, tiempos);
+    return 1;
+}
+
+typedef struct {
+    const char* nombre;
+    MotorConvolucionCPU funcion;    // NULL = OpenCL
+    MotorConvolucionGPU gpu;
+} MotorBench;
+
+static const MotorBench motores[] = {
+    { "secuencial", convolucion_secuencial, NULL },
+    { "simd",       convolucion_simd, NULL },
+    { "hilos",      convolucion_hilos, NULL },
+    { "fft",        convolucion_fft, NULL },
+    { "auto",       convolucion_auto, NULL },
+    { "opencl",     NULL, motor_opencl },
+    { "opencl-img", NULL, convolucion_paralelo_imagen },
+};
+#define NUM_MOTORES ((int)(sizeof(motores) / sizeof(motores[0])))
+
+// Fases de la GPU que se miden en cada repetición
+enum { FASE_TOTAL, FASE_SUBIDA, FASE_KERNEL, FASE_BAJADA, NUM_FASES_GPU };
+static const char* nombres_fases[NUM_FASES_GPU] = { "total", "subida", "kernel", "bajada" };
+
+// Máximo de valores en --tamanos y --ks
+#define MAX_LISTA 32
+
+// Parámetros comunes a todas las medidas
+typedef struct {
+    const char* filtro;
+    int calentamiento;
+    int repeticiones;
+} ConfigBench;
+
+// Reserva de la imagen de entrada en memoria de CLManager (ver load_image_en)
+static unsigned char* reservar_host(void* contexto, size_t bytes) {
+    return CLManager_AllocHost((CLManager*)contexto, bytes);
+}
+
+// Imagen sintética (ruido determinista)
+static void generar_imagen(unsigned char* datos, size_t pixeles) {
+    unsigned int semilla = 12345u;
+    for (size_t i = 0; i < pixeles; i++) {
+        datos[i] = (unsigned char)aleatorio_siguiente(&semilla);
+    }
+}
+
+// Filtro de prueba: 'general' no es separable ni uniforme (fuerza la convolución directa)
+static void generar_filtro(const char* tipo, float* pesos, int k_size) {
+    int half = k_size / 2;
+    float suma = 0.0f;
+    for (int y = 0; y < k_size; y++) {
+        for (int x = 0; x < k_size; x++) {
+            float v;
+            if (strcmp(tipo, "caja") == 0) {
+                v = 1.0f;
+            } else if (strcmp(tipo, "gauss") == 0) {
+                float sigma = k_size / 6.0f + 0.5f;
+                v = expf(-(float)((x - half) * (x - half) + (y - half) * (y - half)) / (2.0f * sigma * sigma));
+            } else {
+                v = 1.0f + (float)((x * 7 + y * 13 + x * y) % 5);
+            }
+            pesos[y * k_size + x] = v;
+            suma += v;
+        }
+    }
+    for (int i = 0; i < k_size * k_size; i++) pesos[i] /= suma;
+}
+
+// "3,5,7" -> {3, 5, 7}. Devuelve cuántos valores leyó (0 si hay basura)
+static int leer_lista(const char* texto, int* valores, int max) {
+    int n = 0;
+    while (*texto && n < max) {
+        char* fin;
+        long v = strtol(texto, &fin, 10);
+        if (fin == texto || v <= 0) return 0;
+        valores[n++] = (int)v;
+        texto = (*fin == ',') ? fin + 1 : fin;
+        if (*fin && *fin != ',') return 0;
+    }
+    return n;
+}
+
+static int buscar_motor(const char* nombre) {
+    for (int m = 0; m < NUM_MOTORES; m++) {
+        if (strcmp(motores[m].nombre, nombre) == 0) return m;
+    }
+    return -1;
+}
+
+/**
+ * Mide los motores activos en un punto (imagen, filtro) y agrega sus filas a la tabla.
+ * @param activos   activos[m] != 0 para medir el motor m.
+ * @param medianas  Recibe la mediana del tiempo total de cada motor medido (ms).
+ * @return 1 si todo fue bien, 0 si faltó memoria.
+ */
+static int medir_punto(CLManager* mgr, const ConfigBench* config, unsigned char* input, unsigned char* out_cpu,
+                       unsigned char* out_gpu, int width, int height, int k_size, const int* activos,
+                       double* medianas, TablaBench* tabla) {
+    int reps = config->repeticiones;
+    size_t pixeles = (size_t)width * height;
+    double* muestras = (double*)malloc(sizeof(double) * reps * NUM_FASES_GPU);
+    float* pesos = (float*)malloc(sizeof(float) * k_size * k_size);
+    int ok = (muestras && pesos);
+    if (!ok) goto cleanup;
+    generar_filtro(config->filtro, pesos, k_size);
+
+    // Los cruces directo / FFT (CPU y GPU) se calibran aquí, fuera de las medidas
+    if (k_size >= FILTRO_K_MIN_FFT) fft_calibracion_cpu();
+    convolucion_paralelo_calibrar(mgr, k_size);
+
+    for (int m = 0; m < NUM_MOTORES && ok; m++) {
+        if (!activos[m]) continue;
+
+        if (motores[m].funcion) {
+            // --- CPU ---
+            for (int r = 0; r < config->calentamiento; r++) {
+                motores[m].funcion(input, out_cpu, width, height, pesos, k_size);
+            }
+            for (int r = 0; r < reps; r++) {
+                double t0 = reloj_ms();
+                motores[m].funcion(input, out_cpu, width, height, pesos, k_size);
+                muestras[r] = reloj_ms() - t0;
+            }
+            ok = tabla_agregar(tabla, motores[m].nombre, "total", width, height, k_size, config->filtro,
+                               muestras, reps, 2.0 * pixeles);
+        } else {
+            // --- GPU ---
+            // total = de host a host (incluye la preparación del filtro y las esperas);
+            // subida / kernel / bajada = profiling de eventos
+            PlanoImagen entrada = { input, width, height, (size_t)width };
+            PlanoImagen salida = { out_gpu, width, height, (size_t)width };
+            TiemposGPU tiempos;
+            // La primera ejecución (de calentamiento o, con --calentamiento 0, ya medida)
+            // comprueba además que el motor está disponible en este dispositivo
+            int disponible = 1;
+            for (int r = 0; r < config->calentamiento + reps && disponible; r++) {
+                double t0 = reloj_ms();
+                int hecho = motores[m].gpu(mgr, &entrada, &salida, pesos, k_size, &tiempos);
+                double ms = reloj_ms() - t0;
+                if (r == 0 && !hecho) {
+                    disponible = 0;
+                } else if (r >= config->calentamiento) {
+                    int i = r - config->calentamiento;
+                    muestras[FASE_TOTAL * reps + i] = ms;
+                    muestras[FASE_SUBIDA * reps + i] = tiempos.subida_ms;
+                    muestras[FASE_KERNEL * reps + i] = tiempos.kernel_ms;
+                    muestras[FASE_BAJADA * reps + i] = tiempos.bajada_ms;
+                }
+            }
+            if (!disponible) {
+                printf("Aviso: motor %s no disponible en este dispositivo, se omite.\n", motores[m].nombre);
+                continue;
+            }
+            // GB/s cuenta una lectura y una escritura por píxel (solo una en subida y bajada)
+            const double bytes_fase[NUM_FASES_GPU] = { 2.0 * pixeles, (double)pixeles, 2.0 * pixeles, (double)pixeles };
+            for (int f = 0; f < NUM_FASES_GPU && ok; f++) {
+                ok = tabla_agregar(tabla, motores[m].nombre, nombres_fases[f], width, height, k_size, config->filtro,
+                                   muestras + f * reps, reps, bytes_fase[f]);
+            }
+        }
+        // Mediana del tiempo total del motor (para descartarlo en imágenes mayores)
+        if (ok) {
+            int fila_total = tabla->num_filas - (motores[m].funcion ? 1 : NUM_FASES_GPU);
+            medianas[m] = tabla->filas[fila_total].e.mediana;
+        }
+    }
+
+cleanup:
+    free(pesos);
+    free(muestras);
+    return ok;
+}
+
+// Matriz tamaño x k con el motor más rápido (mediana del tiempo total) de cada punto
+static void imprimir_mas_rapidos(const TablaBench* tabla, const int* tamanos, int num_tamanos,
+                                 const int* ks, int num_ks) {
+    printf("\nMotor mas rapido (mediana del tiempo total)\n%-8s", "Imagen");
+    for (int j = 0; j < num_ks; j++) printf(" %10s%-2d", "k=", ks[j]);
+    printf("\n");
+    for (int i = 0; i < num_tamanos; i++) {
+        printf("%-8d", tamanos[i]);
+        for (int j = 0; j < num_ks; j++) {
+            const FilaBench* mejor = NULL;
+            for (int f = 0; f < tabla->num_filas; f++) {
+                const FilaBench* fila = &tabla->filas[f];
+                if (fila->width != tamanos[i] || fila->k_size != ks[j] || strcmp(fila->fase, "total") != 0) continue;
+                if (!mejor || fila->e.mediana < mejor->e.mediana) mejor = fila;
+            }
+            printf(" %12s", mejor ? mejor->motor : "-");
+        }
+        printf("\n");
+    }
+}
+
+int main(int argc, char* argv[]) {
+    // --- ARGUMENTOS ---
+    const char* ruta_imagen = NULL;
+    const char* ruta_csv = NULL;
+    const char* ruta_json = NULL;
+    ConfigBench config = { "general", 2, 10 };
+    int width = 3840, height = 2160;
+    int k_size = 5;
+    int barrido = 0;
+    int tamanos[MAX_LISTA] = { 256, 512, 1024, 2048, 4096, 8192, 16384 };
+    int num_tamanos = 7;
+    int ks[MAX_LISTA] = { 3, 5, 7, 9, 11, 13, 15, 17, 19, 21, 23, 25, 27, 29, 31 };
+    int num_ks = 15;
+    double limite_ms = 2000.0;     // En el barrido, un motor más lento que esto no sigue a imágenes mayores
+    int activos[NUM_MOTORES];
+    for (int m = 0; m < NUM_MOTORES; m++) activos[m] = 1;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--ancho") == 0 && i + 1 < argc) {
+            width = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--alto") == 0 && i + 1 < argc) {
+            height = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--k") == 0 && i + 1 < argc) {
+            k_size = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--filtro") == 0 && i + 1 < argc) {
+            config.filtro = argv[++i];
+        } else if (strcmp(argv[i], "--calentamiento") == 0 && i + 1 < argc) {
+            config.calentamiento = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--repeticiones") == 0 && i + 1 < argc) {
+            config.repeticiones = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--barrido") == 0) {
+            barrido = 1;
+        } else if (strcmp(argv[i], "--tamanos") == 0 && i + 1 < argc) {
+            num_tamanos = leer_lista(argv[++i], tamanos, MAX_LISTA);
+        } else if (strcmp(argv[i], "--ks") == 0 && i + 1 < argc) {
+            num_ks = leer_lista(argv[++i], ks, MAX_LISTA);
+        } else if (strcmp(argv[i], "--limite-ms") == 0 && i + 1 < argc) {
+            limite_ms = atof(argv[++i]);
+        } else if (strcmp(argv[i], "--motores") == 0 && i + 1 < argc) {
+            // Lista separada por comas: solo esos motores
+            char lista[256];
+            snprintf(lista, sizeof(lista), "%s", argv[++i]);
+            for (int m = 0; m < NUM_MOTORES; m++) activos[m] = 0;
+            for (char* nombre = strtok(lista, ","); nombre; nombre = strtok(NULL, ",")) {
+                int m = buscar_motor(nombre);
+                if (m < 0) {
+                    printf("Error: Motor desconocido '%s' (opciones: secuencial, simd, hilos, fft, auto, opencl, opencl-img)\n", nombre);
+                    return 1;
+                }
+                activos[m] = 1;
+            }
+        } else if (strcmp(argv[i], "--csv") == 0 && i + 1 < argc) {
+            ruta_csv = argv[++i];
+        } else if (strcmp(argv[i], "--json") == 0 && i + 1 < argc) {
+            ruta_json = argv[++i];
+        } else {
+            ruta_imagen = argv[i];
+        }
+    }
+    if (!barrido) {
+        num_ks = 1;
+        ks[0] = k_size;
+    }
+    for (int j = 0; j < num_ks; j++) {
+        if (ks[j] < 1 || ks[j] % 2 == 0 || ks[j] > FILTRO_K_MAX) {
+            printf("Error: k debe ser impar (1..%d)\n", FILTRO_K_MAX);
+            return 1;
+        }
+    }
+    if (num_tamanos == 0 || num_ks == 0 || config.repeticiones < 1 || config.calentamiento < 0) {
+        printf("Error: listas vacias o invalidas, repeticiones >= 1 y calentamiento >= 0\n");
+        return 1;
+    }
+
+    // --- SETUP ---
+    CLManager mgr;
+    if (!CLManager_Init(&mgr)) return 1;
+    if (!CLManager_LoadKernel(&mgr, "kernels/convolucion.cl", "conv2d")) return 1;
+
+    TablaBench tabla;
+    tabla_iniciar(&tabla);
+    int ok = 1;
+
+    // descartado[j * NUM_MOTORES + m]: el motor m superó limite_ms con ks[j] en una imagen menor
+    int* descartado = (int*)calloc((size_t)num_ks * NUM_MOTORES, sizeof(int));
+    if (!descartado) {
+        printf("Error: Fallo de memoria.\n");
+        return 1;
+    }
+
+    // Un tamaño de imagen por vuelta (solo uno sin --barrido). Entrada y salida de
+    // la GPU en memoria de CLManager_AllocHost, como en el programa principal
+    int vueltas = barrido ? num_tamanos : 1;
+    for (int i = 0; i < vueltas && ok; i++) {
+        unsigned char* input = NULL;
+        if (barrido) {
+            width = height = tamanos[i];
+        }
+        if (ruta_imagen && !barrido) {
+            int canales_archivo;
+            input = load_image_en(ruta_imagen, &width, &height, &canales_archivo, 1, reservar_host, &mgr);
+        } else {
+            input = CLManager_AllocHost(&mgr, (size_t)width * height);
+            if (input) generar_imagen(input, (size_t)width * height);
+        }
+
+        size_t pixeles = (size_t)width * height;
+        unsigned char* out_cpu = (unsigned char*)malloc(pixeles);
+        unsigned char* out_gpu = CLManager_AllocHost(&mgr, pixeles);
+        ok = (input && out_cpu && out_gpu);
+        if (!ok) printf("Error: Fallo de memoria para una imagen de %d x %d.\n", width, height);
+
+        for (int j = 0; j < num_ks && ok; j++) {
+            int activos_punto[NUM_MOTORES];
+            double medianas[NUM_MOTORES] = { 0 };
+            for (int m = 0; m < NUM_MOTORES; m++) activos_punto[m] = activos[m] && !descartado[j * NUM_MOTORES + m];
+
+            printf("\n=== Imagen %d x %d, filtro %s %dx%d ===\n", width, height, config.filtro, ks[j], ks[j]);
+            ok = medir_punto(&mgr, &config, input, out_cpu, out_gpu, width, height, ks[j],
+                             activos_punto, medianas, &tabla);
+
+            // El coste crece con la imagen: un motor ya demasiado lento se descarta para este k
+            for (int m = 0; m < NUM_MOTORES && barrido; m++) {
+                if (activos_punto[m] && medianas[m] > limite_ms) {
+                    descartado[j * NUM_MOTORES + m] = 1;
+                    printf("[Info] %s tarda %.0f ms con k=%d: no se mide en imagenes mayores\n",
+                           motores[m].nombre, medianas[m], ks[j]);
+                }
+            }
+        }
+
+        free(out_cpu);
+        CLManager_FreeHost(&mgr, out_gpu);
+        CLManager_FreeHost(&mgr, input);
+        // Las imágenes siguientes son más grandes: los buffers de dispositivo no se reutilizan
+        CLManager_TrimBuffers(&mgr, 0);
+    }
+
+    // --- RESULTADOS ---
+    printf("\nFiltro %s, %d calentamiento + %d repeticiones (Mpx/s y GB/s con la mediana)\n",
+           config.filtro, config.calentamiento, config.repeticiones);
+    tabla_imprimir(&tabla);
+    if (barrido) imprimir_mas_rapidos(&tabla, tamanos, num_tamanos, ks, num_ks);
+    if (ruta_csv && tabla_escribir_csv(&tabla, ruta_csv)) printf("Resultados guardados: %s\n", ruta_csv);
+    if (ruta_json && tabla_escribir_json(&tabla, ruta_json)) printf("Resultados guardados: %s\n", ruta_json);
+
+    free(descartado);
+    tabla_liberar(&tabla);
+    CLManager_Cleanup(&mgr);
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,108 @@
+// bench/bench_interior.c
+// Mide el throughput (píxeles/s) del rectángulo interior de la convolución en CPU:
+//   - Antes:   bucle original de convolucion_secuencial con 4 comparaciones de clamp por tap
+//   - Después: convolucion_interior() (sin ramas, autovectorizable)
+// Uso: bench_interior [ancho] [alto] [repeticiones]
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "aleatorio.h"
+#include "convolucion_secuencial.h"
+#include "reloj.h"
+
+// Copia del bucle de convolucion_secuencial antes de separar interior y borde
+static void interior_con_clamp(const unsigned char* input, unsigned char* output,
+                               int width, int height, const float* kernel, int k_size) {
+    int half = k_size / 2;
+    for (int y = half; y < height - half; y++) {
+        for (int x = half; x < width - half; x++) {
+            float sum = 0.0f;
+            for (int ky = -half; ky <= half; ky++) {
+                for (int kx = -half; kx <= half; kx++) {
+                    int ix = x + kx;
+                    int iy = y + ky;
+                    if(ix < 0) ix = 0;
+                    if(ix >= width) ix = width - 1;
+                    if(iy < 0) iy = 0;
+                    if(iy >= height) iy = height - 1;
+                    sum += (float)input[iy * width + ix] * kernel[(ky + half) * k_size + (kx + half)];
+                }
+            }
+            if (sum < 0) sum = 0;
+            if (sum > 255) sum = 255;
+            output[y * width + x] = (unsigned char)sum;
+        }
+    }
+}
+
+static void interior_sin_ramas(const unsigned char* input, unsigned char* output,
+                               int width, int height, const float* kernel, int k_size) {
+    int half = k_size / 2;
+    for (int y = half; y < height - half; y++) {
+        convolucion_interior(input, output, width, kernel, k_size, y, half, width - half);
+    }
+}
+
+typedef void (*FuncionInterior)(const unsigned char*, unsigned char*, int, int, const float*, int);
+
+// Mejor tiempo de 'reps' ejecuciones (tras una de calentamiento)
+static double medir(FuncionInterior f, const unsigned char* in, unsigned char* out,
+                    int width, int height, const float* kernel, int k_size, int reps) {
+    f(in, out, width, height, kernel, k_size);
+    double mejor = 1e30;
+    for (int r = 0; r < reps; r++) {
+        double t0 = reloj_ms();
+        f(in, out, width, height, kernel, k_size);
+        double t = reloj_ms() - t0;
+        if (t < mejor) mejor = t;
+    }
+    return mejor;
+}
+
+int main(int argc, char* argv[]) {
+    int width  = argc > 1 ? atoi(argv[1]) : 3840;
+    int height = argc > 2 ? atoi(argv[2]) : 2160;
+    int reps   = argc > 3 ? atoi(argv[3]) : 5;
+    const int tamanos[] = { 3, 5, 7, 9 };
+
+    unsigned char* input = (unsigned char*)malloc((size_t)width * height);
+    unsigned char* out_antes = (unsigned char*)calloc((size_t)width * height, 1);
+    unsigned char* out_despues = (unsigned char*)calloc((size_t)width * height, 1);
+    if (!input || !out_antes || !out_despues) {
+        printf("Error: Fallo de memoria.\n");
+        return 1;
+    }
+
+    // Imagen sintética (ruido determinista)
+    unsigned int semilla = 12345u;
+    for (size_t i = 0; i < (size_t)width * height; i++) {
+        input[i] = (unsigned char)aleatorio_siguiente(&semilla);
+    }
+
+    printf("Interior de %d x %d, mejor de %d repeticiones\n", width, height, reps);
+    printf("%-6s %16s %16s %9s %s\n", "Filtro", "Antes (Mpx/s)", "Despues (Mpx/s)", "Mejora", "Resultado");
+
+    for (size_t t = 0; t < sizeof(tamanos) / sizeof(tamanos[0]); t++) {
+        int k = tamanos[t];
+        float* kernel = (float*)malloc(sizeof(float) * k * k);
+        for (int i = 0; i < k * k; i++) kernel[i] = 1.0f / (k * k);
+
+        double ms_antes = medir(interior_con_clamp, input, out_antes, width, height, kernel, k, reps);
+        double ms_despues = medir(interior_sin_ramas, input, out_despues, width, height, kernel, k, reps);
+
+        double px = (double)(width - 2 * (k / 2)) * (height - 2 * (k / 2));
+        int iguales = memcmp(out_antes, out_despues, (size_t)width * height) == 0;
+
+        printf("%dx%-4d %16.1f %16.1f %8.2fx %s\n", k, k,
+               px / (ms_antes * 1000.0), px / (ms_despues * 1000.0),
+               ms_antes / ms_despues, iguales ? "identico" : "DIFERENTE");
+        free(kernel);
+    }
+
+    free(input);
+    free(out_antes);
+    free(out_despues);
+    return 0;
+}
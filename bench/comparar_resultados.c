@@ -0,0 +1,109 @@
+// bench/comparar_resultados.c
+// Compara dos archivos de resultados JSON (bench_convolucion --json o el programa
+// principal con --json) y marca como regresión cada medida cuya mediana empeora
+// más de un umbral. Las filas se emparejan por motor, fase, imagen, k y filtro.
+// Una medida de la base que falta en el nuevo archivo (un motor o un tamaño que
+// desapareció o que falló) cuenta como FALTA.
+// Código de salida: 0 sin regresiones, 1 con alguna regresión o medida que falta,
+// 2 si hubo error (pensado para bloquear un despliegue desde un script).
+// Uso: comparar_resultados base.json nuevo.json [--umbral porcentaje] [--minimo-ms ms]
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "resultados.h"
+
+static int misma_medida(const FilaBench* a, const FilaBench* b) {
+    return strcmp(a->motor, b->motor) == 0 && strcmp(a->fase, b->fase) == 0 &&
+           a->width == b->width && a->height == b->height && a->k_size == b->k_size &&
+           strcmp(a->filtro, b->filtro) == 0;
+}
+
+int main(int argc, char* argv[]) {
+    // --- ARGUMENTOS ---
+    const char* rutas[2] = { NULL, NULL };
+    int num_rutas = 0;
+    double umbral = 10.0;       // % de aumento de la mediana que se considera regresión
+    double minimo_ms = 0.05;    // Diferencias absolutas menores son ruido (fases casi vacías)
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--umbral") == 0 && i + 1 < argc) {
+            umbral = atof(argv[++i]);
+        } else if (strcmp(argv[i], "--minimo-ms") == 0 && i + 1 < argc) {
+            minimo_ms = atof(argv[++i]);
+        } else if (num_rutas < 2) {
+            rutas[num_rutas++] = argv[i];
+        }
+    }
+    if (num_rutas < 2) {
+        printf("Uso: %s base.json nuevo.json [--umbral porcentaje] [--minimo-ms ms]\n", argv[0]);
+        return 2;
+    }
+
+    TablaBench base, nuevo;
+    tabla_iniciar(&base);
+    tabla_iniciar(&nuevo);
+    if (tabla_leer_json(&base, rutas[0]) < 0 || tabla_leer_json(&nuevo, rutas[1]) < 0) {
+        tabla_liberar(&base);
+        tabla_liberar(&nuevo);
+        return 2;
+    }
+
+    // --- COMPARACIÓN ---
+    int regresiones = 0, mejoras = 0, sin_pareja = 0, faltan = 0;
+    printf("%-11s %-14s %11s %4s %12s %12s %9s  %s\n",
+           "Motor", "Fase", "Imagen", "k", "Base (ms)", "Nuevo (ms)", "Cambio", "Estado");
+    for (int i = 0; i < nuevo.num_filas; i++) {
+        const FilaBench* n = &nuevo.filas[i];
+        const FilaBench* b = NULL;
+        for (int j = 0; j < base.num_filas && !b; j++) {
+            if (misma_medida(&base.filas[j], n)) b = &base.filas[j];
+        }
+        if (!b) {
+            sin_pareja++;
+            continue;
+        }
+
+        double diferencia = n->e.mediana - b->e.mediana;
+        double cambio = b->e.mediana > 0.0 ? 100.0 * diferencia / b->e.mediana : 0.0;
+        const char* estado = "";
+        if (diferencia > minimo_ms && cambio > umbral) {
+            estado = "REGRESION";
+            regresiones++;
+        } else if (-diferencia > minimo_ms && -cambio > umbral) {
+            estado = "mejora";
+            mejoras++;
+        }
+
+        char imagen[24];
+        snprintf(imagen, sizeof(imagen), "%dx%d", n->width, n->height);
+        printf("%-11s %-14s %11s %4d %12.3f %12.3f %+8.1f%%  %s\n",
+               n->motor, n->fase, imagen, n->k_size, b->e.mediana, n->e.mediana, cambio, estado);
+    }
+
+    // Medidas de la base sin pareja en el nuevo archivo
+    for (int j = 0; j < base.num_filas; j++) {
+        const FilaBench* b = &base.filas[j];
+        int encontrada = 0;
+        for (int i = 0; i < nuevo.num_filas && !encontrada; i++) {
+            encontrada = misma_medida(b, &nuevo.filas[i]);
+        }
+        if (encontrada) continue;
+
+        faltan++;
+        char imagen[24];
+        snprintf(imagen, sizeof(imagen), "%dx%d", b->width, b->height);
+        printf("%-11s %-14s %11s %4d %12.3f %12s %9s  %s\n",
+               b->motor, b->fase, imagen, b->k_size, b->e.mediana, "-", "-", "FALTA");
+    }
+
+    printf("\n%d regresiones y %d mejoras de mas del %.1f%% (y %.3f ms)", regresiones, mejoras, umbral, minimo_ms);
+    if (faltan) printf(", %d medidas de %s que faltan en %s", faltan, rutas[0], rutas[1]);
+    if (sin_pareja) printf(", %d medidas sin pareja en %s", sin_pareja, rutas[0]);
+    printf("\n");
+
+    tabla_liberar(&base);
+    tabla_liberar(&nuevo);
+    return (regresiones || faltan) ? 1 : 0;
+}
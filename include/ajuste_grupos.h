@@ -0,0 +1,53 @@
+#ifndef AJUSTE_GRUPOS_H
+#define AJUSTE_GRUPOS_H
+
+#include <CL/cl.h>
+
+/**
+ * Base de datos en disco de tamaños de work-group ajustados (autotuning).
+ *
+ * Con local_work_size = NULL el runtime elige un tamaño genérico, a menudo lejos
+ * del óptimo para un stencil 2D. convolucion_paralelo_ajustar() mide una rejilla
+ * de tamaños locales y guarda el ganador aquí; al lanzar, encolar_conv2d consulta
+ * la base antes de usar su tamaño por defecto (y, si ambas variantes están
+ * ajustadas, usa la más rápida).
+ *
+ * Cada entrada se identifica por el nombre del dispositivo, la variante de kernel
+ * (ej. "conv2d_tiles"), la clase de tamaño de imagen y k_size. El archivo es texto
+ * (una entrada por línea, campos separados por tabuladores) en el directorio de la
+ * caché de binarios: CL_CACHE_DIR o "cache_cl". La copia en memoria está protegida
+ * por un mutex (se puede consultar y registrar desde varios hilos) y el archivo se
+ * reemplaza de una vez, así que otro proceso nunca lo ve a medias.
+ */
+
+// Nombre del archivo dentro del directorio de la caché
+#define AJUSTE_ARCHIVO "ajuste_grupos.txt"
+
+// Máximo de entradas que se mantienen en memoria (las demás se ignoran)
+#define AJUSTE_MAX_ENTRADAS 256
+
+/**
+ * Clase de tamaño de una imagen: la menor potencia de 2 >= max(width, height),
+ * con mínimo 64. Imágenes de la misma clase comparten el ajuste.
+ */
+int ajuste_clase(int width, int height);
+
+/**
+ * Busca el tamaño local ajustado para el punto. La primera llamada carga el archivo.
+ * @param local  Recibe el tamaño local (x, y) si se encontró; {0, 0} significa
+ *               que ganó el tamaño que elige el runtime (local_work_size = NULL).
+ * @param ms     Si no es NULL, recibe el tiempo de kernel medido con ese tamaño.
+ * @return 1 si hay entrada, 0 si no.
+ */
+int ajuste_buscar(cl_device_id device, const char* variante, int width, int height, int k_size,
+                  size_t local[2], double* ms);
+
+/**
+ * Registra (o reemplaza) el ganador de un punto y reescribe el archivo.
+ * @param ms  Tiempo de kernel del ganador (permite comparar variantes al lanzar).
+ * @return 1 si se guardó en disco, 0 si no.
+ */
+int ajuste_registrar(cl_device_id device, const char* variante, int width, int height, int k_size,
+                     const size_t local[2], double ms);
+
+#endif // AJUSTE_GRUPOS_H
@@ -0,0 +1,11 @@
+#ifndef ALEATORIO_H
+#define ALEATORIO_H
+
+/**
+ * Generador congruencial lineal de las imágenes y filtros sintéticos (benchmarks,
+ * calibraciones y ajuste): avanza *semilla y devuelve sus 16 bits altos.
+ * @param semilla Estado del generador (12345 en todos los usos, para datos repetibles).
+ */
+unsigned int aleatorio_siguiente(unsigned int* semilla);
+
+#endif // ALEATORIO_H
@@ -0,0 +1,49 @@
+#ifndef CACHE_PROGRAMAS_H
+#define CACHE_PROGRAMAS_H
+
+#include <CL/cl.h>
+
+/**
+ * Caché en disco de binarios de programas OpenCL.
+ *
+ * Compilar convolucion.cl desde fuente cuesta cientos de ms en algunos drivers
+ * y domina en ejecuciones cortas. El binario compilado (CL_PROGRAM_BINARIES) se
+ * guarda en un archivo cuyo nombre es un hash de la fuente, las opciones de build,
+ * la plataforma, el dispositivo y la versión del driver: cualquier cambio produce
+ * otra clave y el binario viejo simplemente deja de usarse.
+ *
+ * El directorio es CL_CACHE_DIR si está definido, o "cache_cl" junto al ejecutable.
+ */
+
+// Directorio por defecto (relativo al directorio de trabajo)
+#define CACHE_PROGRAMAS_DIR "cache_cl"
+
+/**
+ * Devuelve el programa construido para 'device'. Intenta primero el binario
+ * cacheado (clCreateProgramWithBinary); si no existe, no corresponde o falla
+ * su build, compila desde la fuente y guarda el binario resultante.
+ * @param opciones  Opciones de clBuildProgram (NULL = ninguna).
+ * @param desde_cache  Si no es NULL, recibe 1 si se usó el binario cacheado.
+ * @return El programa (también si el build desde fuente falló, para poder leer
+ *         el log con clGetProgramBuildInfo), o NULL si no se pudo crear. 'err'
+ *         recibe el resultado de clBuildProgram.
+ */
+cl_program cache_programa_construir(cl_context context, cl_platform_id platform, cl_device_id device,
+                                    const char* fuente, size_t tam_fuente, const char* opciones,
+                                    int* desde_cache, cl_int* err);
+
+/**
+ * Nombre del temporal para reescribir 'ruta' ("ruta.<pid>.tmp"): dos procesos que
+ * guardan el mismo archivo a la vez no escriben en el mismo temporal.
+ */
+void cache_ruta_temporal(char* ruta_tmp, size_t max, const char* ruta);
+
+/**
+ * Reemplaza 'ruta' por el temporal ya cerrado de una sola vez (rename sobre el
+ * destino en POSIX, MoveFileEx con MOVEFILE_REPLACE_EXISTING en Windows): el
+ * archivo nunca deja de existir. Si falla se borra el temporal.
+ * @return 1 si se reemplazó, 0 si no.
+ */
+int cache_reemplazar_archivo(const char* ruta_tmp, const char* ruta);
+
+#endif // CACHE_PROGRAMAS_H
@@ -4,6 +4,52 @@
 #include <CL/cl.h>
 #include <stdio.h>
 
+// Máximo de kernels distintos que se cachean a partir del mismo programa
+#define CL_MANAGER_MAX_KERNELS 32
+
+// Máximo de buffers de dispositivo que guarda el pool (en uso + libres)
+#define CL_MANAGER_MAX_BUFFERS 32
+
+// Entrada del pool de buffers: se reutiliza para pedidos con los mismos flags
+// y un tamaño menor o igual
+typedef struct {
+    cl_mem buffer;
+    size_t bytes;
+    cl_mem_flags flags;
+    int en_uso;
+} CLBufferPool;
+
+// Máximo de bloques de memoria de host registrados (CLManager_AllocHost)
+#define CL_MANAGER_MAX_HOST 16
+
+// Alineación y granularidad de la memoria zero-copy (los drivers integrados
+// solo evitan la copia con páginas de 4 KB y tamaños múltiplos de 64 bytes)
+#define CL_MANAGER_ALINEACION_HOST 4096
+#define CL_MANAGER_GRANO_HOST 64
+
+// Bloque de memoria de host respaldado por un buffer OpenCL
+typedef struct {
+    cl_mem buffer;
+    unsigned char* ptr;     // Lo que ve el llamador
+    size_t bytes;
+    int zero_copy;          // 1 = CL_MEM_USE_HOST_PTR sobre ptr; 0 = ALLOC_HOST_PTR mapeado (pinned)
+} CLMemoriaHost;
+
+// Máximo de variantes especializadas del programa (CLManager_GetKernelVariante) y
+// de kernels cacheados en cada una
+#define CL_MANAGER_MAX_VARIANTES 16
+#define CL_MANAGER_MAX_KERNELS_VARIANTE 8
+
+// Programa compilado con opciones de build propias (por ejemplo "-D KSIZE=5")
+typedef struct {
+    char* opciones;                 // Clave de la variante (malloc)
+    cl_program program;             // NULL si su build falló (no se reintenta)
+    cl_kernel kernels[CL_MANAGER_MAX_KERNELS_VARIANTE];
+    char nombres_kernels[CL_MANAGER_MAX_KERNELS_VARIANTE][64];
+    int num_kernels;
+    unsigned long ultimo_uso;       // Para reemplazar la menos usada cuando no hay hueco
+} CLVariante;
+
 // Estructura para mantener organizado el entorno OpenCL
 typedef struct {
     cl_platform_id platform_id;
@@ -12,6 +58,30 @@ typedef struct {
     cl_command_queue queue;
     cl_program program;
     cl_kernel kernel;
+
+    // Kernels adicionales del programa, creados bajo demanda por CLManager_GetKernel
+    cl_kernel kernels[CL_MANAGER_MAX_KERNELS];
+    char nombres_kernels[CL_MANAGER_MAX_KERNELS][64];
+    int num_kernels;
+
+    // Fuente del programa (se conserva para compilar variantes) y variantes compiladas
+    char* fuente;
+    size_t tam_fuente;
+    CLVariante variantes[CL_MANAGER_MAX_VARIANTES];
+    int num_variantes;
+    unsigned long usos_variantes;
+
+    // Pool de buffers de dispositivo reutilizados entre llamadas (AcquireBuffer / ReleaseBuffer)
+    CLBufferPool buffers[CL_MANAGER_MAX_BUFFERS];
+    int num_buffers;
+    unsigned long pool_aciertos;    // Pedidos servidos con un buffer ya existente
+    unsigned long pool_fallos;      // Pedidos que crearon (o agrandaron) un buffer
+    size_t pool_bytes;              // Bytes de dispositivo retenidos por el pool
+
+    // Memoria de host lista para transferir (AllocHost / FreeHost)
+    CLMemoriaHost host[CL_MANAGER_MAX_HOST];
+    int num_host;
+    int memoria_unificada;          // CL_DEVICE_HOST_UNIFIED_MEMORY: CPU o GPU integrada
 } CLManager;
 
 // Inicializa Plataforma, Dispositivo, Contexto y Cola
@@ -20,6 +90,67 @@ int CLManager_Init(CLManager* mgr);
 // Lee el código fuente .cl, lo compila y extrae el kernel
 int CLManager_LoadKernel(CLManager* mgr, const char* filename, const char* kernel_name);
 
+/**
+ * Devuelve el kernel 'nombre' del programa ya compilado, creándolo la primera vez.
+ * El kernel queda cacheado en el manager y se libera en CLManager_Cleanup.
+ * @return El kernel, o NULL si no existe o la caché está llena.
+ */
+cl_kernel CLManager_GetKernel(CLManager* mgr, const char* nombre);
+
+/**
+ * Devuelve el kernel 'nombre' de la fuente cargada por CLManager_LoadKernel
+ * compilada con 'opciones' (por ejemplo "-D KSIZE=5"), para que el compilador
+ * de OpenCL trate como constantes valores que de otro modo llegan como argumentos.
+ * Cada conjunto de opciones se compila una vez (con la caché de binarios en disco)
+ * y sus kernels quedan cacheados; con las CL_MANAGER_MAX_VARIANTES ocupadas se
+ * reemplaza la usada hace más tiempo, así que el kernel solo es válido hasta la
+ * siguiente llamada.
+ * @return El kernel, o NULL si la variante no compila (el llamador usa el genérico).
+ */
+cl_kernel CLManager_GetKernelVariante(CLManager* mgr, const char* nombre, const char* opciones);
+
+/**
+ * Pide al pool un buffer de al menos 'bytes' con esos flags (sin COPY/USE_HOST_PTR).
+ * Reutiliza el buffer libre más pequeño que sirva; si solo hay libres más pequeños
+ * se reemplaza uno por otro del tamaño nuevo (el pool crece con la imagen más grande).
+ * Con buffers reutilizados los datos de entrada se suben con clEnqueueWriteBuffer.
+ * @return El buffer, o NULL si falla la creación (err recibe el código).
+ */
+cl_mem CLManager_AcquireBuffer(CLManager* mgr, cl_mem_flags flags, size_t bytes, cl_int* err);
+
+// Devuelve al pool un buffer obtenido con CLManager_AcquireBuffer (NULL se ignora)
+void CLManager_ReleaseBuffer(CLManager* mgr, cl_mem buffer);
+
+/**
+ * Libera buffers libres del pool (los más grandes primero) hasta que el pool
+ * retenga como mucho 'bytes_max' bytes. 0 = liberar todos los libres.
+ */
+void CLManager_TrimBuffers(CLManager* mgr, size_t bytes_max);
+
+// Imprime aciertos, fallos y bytes retenidos por el pool
+void CLManager_PrintPoolStats(const CLManager* mgr);
+
+/**
+ * Reserva memoria de host lista para transferencias.
+ * - Dispositivos con memoria unificada (CPU, GPU integrada): memoria alineada
+ *   envuelta con CL_MEM_USE_HOST_PTR. El dispositivo la usa directamente (zero-copy)
+ *   y convolucion_paralelo no copia nada si recibe este puntero.
+ * - GPU discreta: buffer CL_MEM_ALLOC_HOST_PTR mapeado de forma persistente con
+ *   clEnqueueMapBuffer (memoria pinned: las copias van por DMA sin paso intermedio).
+ * Si no se puede crear el buffer se devuelve memoria normal (malloc).
+ * @return El puntero, o NULL si no hay memoria. Se libera con CLManager_FreeHost.
+ */
+unsigned char* CLManager_AllocHost(CLManager* mgr, size_t bytes);
+
+// Libera memoria de CLManager_AllocHost (NULL se ignora)
+void CLManager_FreeHost(CLManager* mgr, void* ptr);
+
+/**
+ * Si [ptr, ptr + bytes) es el comienzo de un bloque zero-copy de CLManager_AllocHost,
+ * devuelve su buffer (sin transferir el dispositivo accede a esa memoria). Si no, NULL.
+ */
+cl_mem CLManager_HostBuffer(CLManager* mgr, const void* ptr, size_t bytes);
+
 // Libera memoria al terminar
 void CLManager_Cleanup(CLManager* mgr);
 
@@ -0,0 +1,32 @@
+#ifndef CONVOLUCION_AUTO_H
+#define CONVOLUCION_AUTO_H
+
+#include "layout_planar.h"
+
+/**
+ * Motor automático de CPU: analiza el filtro (filtro_analizar) y elige la ruta
+ * más barata. Filtros de caja de k_size >= FILTRO_K_MIN_CAJA van por
+ * convolucion_caja(); otros separables de k_size >= FILTRO_K_MIN_SEPARABLE por
+ * convolucion_separable(); filtros grandes por convolucion_fft() cuando la
+ * calibración (fft_calibracion_cpu) predice que es más barata; el resto por
+ * convolucion_hilos().
+ * Misma firma que convolucion_secuencial().
+ */
+void convolucion_auto(
+    const unsigned char* input,
+    unsigned char* output,
+    int width,
+    int height,
+    const float* kernel,
+    int k_size
+);
+
+// convolucion_auto() sobre planos con pitch: misma elección de ruta
+void convolucion_auto_plano(
+    const PlanoImagen* entrada,
+    const PlanoImagen* salida,
+    const float* kernel,
+    int k_size
+);
+
+#endif // CONVOLUCION_AUTO_H
@@ -0,0 +1,37 @@
+#ifndef CONVOLUCION_CAJA_H
+#define CONVOLUCION_CAJA_H
+
+#include "layout_planar.h"
+
+/**
+ * Filtro de caja (todos los pesos iguales) en CPU con sumas deslizantes:
+ * por cada columna se mantiene la suma vertical de la ventana y por cada fila
+ * se desliza la suma horizontal, así que cada píxel cuesta O(1) sin importar k_size.
+ * Las sumas son enteras (exactas); el único redondeo es suma * peso, por lo que
+ * el resultado puede diferir en +-1 nivel respecto a convolucion_secuencial().
+ * Clamp-to-edge igual que la ruta 2D. Usa el pool de hilos (bandas de filas).
+ * * @param input     Imagen de entrada (0-255).
+ * @param output    Imagen de salida.
+ * @param width     Ancho de la imagen.
+ * @param height    Alto de la imagen.
+ * @param k_size    Lado de la ventana (impar, <= FILTRO_K_MAX).
+ * @param peso      Peso común de los k_size * k_size coeficientes (ej. 1 / k^2).
+ */
+void convolucion_caja(
+    const unsigned char* input,
+    unsigned char* output,
+    int width,
+    int height,
+    int k_size,
+    float peso
+);
+
+// convolucion_caja() sobre planos con pitch
+void convolucion_caja_plano(
+    const PlanoImagen* entrada,
+    const PlanoImagen* salida,
+    int k_size,
+    float peso
+);
+
+#endif // CONVOLUCION_CAJA_H
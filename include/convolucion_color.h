@@ -0,0 +1,26 @@
+#ifndef CONVOLUCION_COLOR_H
+#define CONVOLUCION_COLOR_H
+
+/**
+ * Convolución en CPU de imágenes entrelazadas de 1 a 4 canales (G, GA, RGB, RGBA).
+ * Cada canal se filtra por separado con las mismas sumas (orden ky, kx) que
+ * convolucion_pixel(); el interior recorre los bytes de la fila de corrido
+ * (todos los canales a la vez, taps con paso 'canales') para que se vectorice.
+ * Las bandas de filas se reparten en el pool de hilos compartido.
+ * @param input          Píxeles entrelazados (width * height * canales bytes).
+ * @param output         Buffer de salida del mismo tamaño.
+ * @param canales        Canales por píxel (1-4). En 2 y 4 el último es alfa.
+ * @param filtrar_alpha  0 = el alfa se copia sin filtrar (solo 2 y 4 canales).
+ */
+void convolucion_color(
+    const unsigned char* input,
+    unsigned char* output,
+    int width,
+    int height,
+    int canales,
+    const float* kernel,
+    int k_size,
+    int filtrar_alpha
+);
+
+#endif // CONVOLUCION_COLOR_H
@@ -0,0 +1,55 @@
+#ifndef CONVOLUCION_FFT_H
+#define CONVOLUCION_FFT_H
+
+#include "layout_planar.h"
+
+/**
+ * Convolución en CPU por FFT: O(N log N) independiente de k_size.
+ * La imagen se extiende k_size / 2 píxeles por cada lado replicando el borde
+ * (emula clamp-to-edge) y se rellena con ceros hasta un tamaño 2^a 3^b 5^c;
+ * con eso la convolución circular coincide con la lineal en toda la salida.
+ * Las filas se transforman de dos en dos como una sola FFT compleja
+ * (real-to-complex) y solo se guardan width / 2 + 1 columnas del espectro.
+ * Usa el pool de hilos. El resultado puede diferir en +-1 nivel respecto a
+ * convolucion_secuencial() por el redondeo de la FFT en float.
+ * Misma firma que convolucion_secuencial().
+ */
+void convolucion_fft(
+    const unsigned char* input,
+    unsigned char* output,
+    int width,
+    int height,
+    const float* kernel,
+    int k_size
+);
+
+// convolucion_fft() sobre planos con pitch
+void convolucion_fft_plano(
+    const PlanoImagen* entrada,
+    const PlanoImagen* salida,
+    const float* kernel,
+    int k_size
+);
+
+// Costes medidos en una corrida de calibración, para decidir entre directo y FFT
+typedef struct {
+    double ns_por_tap;      // Convolución directa: ns por píxel y por coeficiente
+    double ns_por_punto;    // FFT: ns por punto * log2(puntos) del tamaño transformado
+} CalibracionFFT;
+
+/**
+ * Calibración de la CPU: la primera llamada mide la convolución directa (motor SIMD)
+ * y la FFT sobre una imagen sintética pequeña, ambas en un solo hilo.
+ */
+const CalibracionFFT* fft_calibracion_cpu(void);
+
+// Puntos * log2(puntos) de la transformada que usaría una imagen width x height
+double fft_coste_puntos(int width, int height, int k_size);
+
+/**
+ * Cruce directo / FFT: 1 si con los costes calibrados la FFT sale más barata.
+ * Filtros de k_size < FILTRO_K_MIN_FFT siempre van por la ruta directa.
+ */
+int fft_conviene(const CalibracionFFT* calibracion, int width, int height, int k_size);
+
+#endif // CONVOLUCION_FFT_H
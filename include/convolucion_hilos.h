@@ -0,0 +1,36 @@
+#ifndef CONVOLUCION_HILOS_H
+#define CONVOLUCION_HILOS_H
+
+#include "layout_planar.h"
+
+/**
+ * Ejecuta la convolución en la CPU usando todos los núcleos.
+ * La imagen se divide en bandas de filas que se reparten en el pool de hilos
+ * compartido (con robo de trabajo); cada banda usa el motor SIMD, por lo que
+ * el resultado es idéntico al de convolucion_secuencial().
+ * El número de hilos se puede fijar con la variable de entorno CONV_HILOS.
+ * * @param input     Puntero a los datos de la imagen de entrada (0-255).
+ * @param output    Puntero al buffer donde se guardará la imagen procesada.
+ * @param width     Ancho de la imagen en píxeles.
+ * @param height    Alto de la imagen en píxeles.
+ * @param kernel    Array de floats con los coeficientes del filtro.
+ * @param k_size    Dimensión del kernel (ej. 3 para una matriz 3x3).
+ */
+void convolucion_hilos(
+    const unsigned char* input,
+    unsigned char* output,
+    int width,
+    int height,
+    const float* kernel,
+    int k_size
+);
+
+// convolucion_hilos() sobre planos con pitch (bandas con convolucion_simd_plano_filas)
+void convolucion_hilos_plano(
+    const PlanoImagen* entrada,
+    const PlanoImagen* salida,
+    const float* kernel,
+    int k_size
+);
+
+#endif // CONVOLUCION_HILOS_H
@@ -2,6 +2,8 @@
 #define CONVOLUCION_PARALELO_H
 
 #include "cl_manager.h"
+#include "convolucion_roi.h"
+#include "layout_planar.h"
 
 /**
  * Ejecuta la convolución usando OpenCL en la GPU.
@@ -24,4 +26,188 @@ void convolucion_paralelo(
     double* kernel_time_ms
 );
 
+/**
+ * Convolución de una imagen RGBA entrelazada (4 bytes por píxel) con el kernel
+ * conv2d_rgba: cada canal se filtra por separado con el mismo filtro.
+ * @param filtrar_alpha  0 = el canal alfa se copia sin filtrar.
+ */
+void convolucion_paralelo_rgba(
+    CLManager* mgr,
+    const unsigned char* input,
+    unsigned char* output,
+    int width,
+    int height,
+    const float* filter,
+    int k_size,
+    int filtrar_alpha,
+    double* kernel_time_ms
+);
+
+/**
+ * convolucion_paralelo() con pitch explícito de entrada y salida: un canal de una
+ * ImagenPlanar, o una región dentro de un frame mayor (datos apunta a la esquina
+ * de la región y pitch es el del frame). Las filas se copian con
+ * Read/WriteBufferRect; en el dispositivo la ruta directa usa filas alineadas a
+ * PLANAR_ALINEACION bytes si alguno de los planos tiene pitch > width (con filas
+ * contiguas, y en las demás rutas, filas contiguas y copias lineales).
+ * Entrada y salida pueden ser la misma memoria (la región se procesa in situ):
+ * la subida termina antes del primer kernel y la salida siempre va a un buffer
+ * aparte en el dispositivo, aunque la memoria sea de CLManager_AllocHost.
+ * @param entrada  Plano de entrada (Host).
+ * @param salida   Plano de salida del mismo width x height; su pitch puede ser otro.
+ */
+void convolucion_paralelo_plano(
+    CLManager* mgr,
+    const PlanoImagen* entrada,
+    const PlanoImagen* salida,
+    const float* filter,
+    int k_size,
+    double* kernel_time_ms
+);
+
+// Tiempos por fase de una convolución en OpenCL (profiling de eventos, ms).
+// Con memoria zero-copy la fase de subida o bajada no copia y queda en 0
+typedef struct {
+    double subida_ms;       // Host -> GPU
+    double kernel_ms;       // Del primer al último kernel de la ruta elegida
+    double bajada_ms;       // GPU -> Host
+} TiemposGPU;
+
+/**
+ * convolucion_paralelo_plano() que devuelve además los tiempos de subida y bajada
+ * (para benchmarks: la suma de las tres fases es el tiempo de GPU sin el host).
+ * @param tiempos  Recibe los tiempos de cada fase.
+ */
+void convolucion_paralelo_fases(
+    CLManager* mgr,
+    const PlanoImagen* entrada,
+    const PlanoImagen* salida,
+    const float* filter,
+    int k_size,
+    TiemposGPU* tiempos
+);
+
+/**
+ * Convolución en OpenCL solo de las regiones de interés (ver convolucion_roi.h):
+ * sube únicamente el halo de cada región (WriteBufferRect), lanza un conv2d por
+ * región con global_work_offset en su esquina y baja solo la región a su sitio
+ * en 'salida'. Todas las regiones comparten la misma cola y un solo clFinish.
+ * @param regiones        Rectángulos (se recortan a la imagen; pueden solaparse).
+ * @param kernel_time_ms  Suma de los tiempos de kernel de todas las regiones.
+ */
+void convolucion_paralelo_roi(
+    CLManager* mgr,
+    const PlanoImagen* entrada,
+    const PlanoImagen* salida,
+    const float* filter,
+    int k_size,
+    const RegionROI* regiones,
+    int num_regiones,
+    double* kernel_time_ms
+);
+
+/**
+ * Convolución directa con la entrada como image2d_t (CL_R / CL_UNORM_INT8) leída
+ * con un sampler CLK_ADDRESS_CLAMP_TO_EDGE: la unidad de texturas resuelve los
+ * bordes y la conversión a float. La imagen se sube con clEnqueueWriteImage y el
+ * resultado (otra imagen) se baja con clEnqueueReadImage, ambos con el pitch de
+ * cada plano. Sirve para cualquier filtro (siempre convolución directa). Por la
+ * precisión de la conversión normalizada, algún píxel puede diferir en una unidad
+ * del resultado de convolucion_paralelo_fases.
+ * @param tiempos  Recibe subida / kernel / bajada (profiling).
+ * @return 1 si se hizo la convolución; 0 si el dispositivo no admite esas
+ *         imágenes o hubo un error (el llamador puede usar convolucion_paralelo_fases).
+ */
+int convolucion_paralelo_imagen(
+    CLManager* mgr,
+    const PlanoImagen* entrada,
+    const PlanoImagen* salida,
+    const float* filter,
+    int k_size,
+    TiemposGPU* tiempos
+);
+
+/**
+ * Autotuning de la convolución directa: mide conv2d, conv2d_tiles y conv2d_bloques
+ * (bloques de 4x1, 8x1 y 4x4 píxeles por work-item) con una rejilla de work-groups
+ * (4..256 x 1..32, los que admita el dispositivo) sobre una imagen sintética de
+ * width x height y guarda el más rápido de cada variante en la base de ajuste (ver
+ * ajuste_grupos.h). Las convoluciones siguientes de la misma clase de tamaño y
+ * k_size en este dispositivo lanzan la variante más rápida con su work-group.
+ * @param repeticiones  Lanzamientos medidos por candidato (se toma el mejor).
+ * @return 1 si se guardó al menos una variante, 0 si no.
+ */
+int convolucion_paralelo_ajustar(
+    CLManager* mgr,
+    int width,
+    int height,
+    int k_size,
+    int repeticiones
+);
+
+/**
+ * Compila de antemano las variantes de conv2d / conv2d_tiles y de conv2d_bloques
+ * (con el bloque por defecto del dispositivo) especializadas para k_size (y, con
+ * CONV_ESPECIALIZAR=pesos, para los pesos de 'filter'), para que la primera
+ * convolución no pague el build. Sin llamarla cada variante se compila en su
+ * primer uso. CONV_ESPECIALIZAR=0 desactiva la especialización.
+ */
+void convolucion_paralelo_especializar(
+    CLManager* mgr,
+    const float* filter,
+    int k_size
+);
+
+/**
+ * Mide de antemano, una vez por dispositivo, el cruce entre la convolución directa
+ * y la FFT en la GPU (solo hace falta si k_size >= FILTRO_K_MIN_FFT; con filtros
+ * menores no hace nada). Sin llamarla, la primera convolución con un filtro grande
+ * calibra dentro de su propia llamada y su tiempo incluye la calibración.
+ * Se puede llamar desde varios hilos.
+ */
+void convolucion_paralelo_calibrar(
+    CLManager* mgr,
+    int k_size
+);
+
+// Máximo de frames en vuelo en convolucion_paralelo_secuencia (triple buffer)
+#define SECUENCIA_MAX_EN_VUELO 3
+
+// Tiempos de GPU de una secuencia (profiling) y solapamiento logrado
+typedef struct {
+    int frames;
+    int en_vuelo;
+    double subida_ms;       // Suma de las subidas Host -> GPU
+    double computo_ms;      // Suma de los cómputos (todos los kernels de cada frame)
+    double bajada_ms;       // Suma de las bajadas GPU -> Host
+    double total_ms;        // Desde la primera subida hasta la última bajada
+    double solapamiento;    // Fracción del tiempo en serie que se ocultó: 1 - total / (subida + computo + bajada)
+} EstadisticasSecuencia;
+
+/**
+ * Convoluciona una secuencia de imágenes (ej. frames de video) del mismo tamaño
+ * con el mismo filtro, manteniendo varios frames en vuelo: la subida del frame
+ * i+1 y la bajada del i-1 se solapan con el cómputo del i (una cola por fase,
+ * dependencias por eventos). La ruta (caja, separable, FFT o directa) se elige
+ * una sola vez para toda la secuencia.
+ * Las entradas y salidas no deben tocarse hasta que la función retorne.
+ * @param entradas   num_frames punteros a imágenes de width x height (Host).
+ * @param salidas    num_frames punteros donde se guardan los resultados (Host).
+ * @param en_vuelo   Frames en vuelo (2 = doble buffer, 3 = triple buffer).
+ * @param stats      Si no es NULL, recibe los tiempos y el solapamiento.
+ * @return 1 si todo fue bien, 0 si hubo error.
+ */
+int convolucion_paralelo_secuencia(
+    CLManager* mgr,
+    const unsigned char* const* entradas,
+    unsigned char* const* salidas,
+    int num_frames,
+    int width,
+    int height,
+    const float* filter,
+    int k_size,
+    int en_vuelo,
+    EstadisticasSecuencia* stats
+);
+
 #endif // CONVOLUCION_PARALELO_H
\ No newline at end of file
@@ -0,0 +1,45 @@
+#ifndef CONVOLUCION_ROI_H
+#define CONVOLUCION_ROI_H
+
+#include "layout_planar.h"
+
+/**
+ * Convolución solo en regiones de interés (ej. objetos detectados en un frame).
+ * Cada región se calcula como si se convolucionara la imagen completa: los
+ * vecinos del halo (k_size / 2 píxeles alrededor) se leen de la imagen y el
+ * clamp-to-edge se aplica en los bordes de la imagen, no de la región.
+ * Los píxeles de la salida fuera de las regiones no se tocan.
+ */
+
+// Rectángulo en píxeles de la imagen: [x, x + width) x [y, y + height)
+typedef struct {
+    int x;
+    int y;
+    int width;
+    int height;
+} RegionROI;
+
+/**
+ * Recorta la región a la imagen.
+ * @return 1 si queda algún píxel, 0 si la región cae fuera.
+ */
+int roi_recortar(const RegionROI* region, int width, int height, RegionROI* recortada);
+
+/**
+ * Convolución en CPU de las regiones (motor SIMD, bandas de filas de todas las
+ * regiones repartidas en el pool de hilos).
+ * @param entrada       Imagen completa.
+ * @param salida        Imagen de salida del mismo tamaño (solo se escriben las regiones).
+ * @param regiones      Rectángulos a calcular (se recortan a la imagen; pueden solaparse).
+ * @param num_regiones  Número de rectángulos.
+ */
+void convolucion_roi(
+    const PlanoImagen* entrada,
+    const PlanoImagen* salida,
+    const float* kernel,
+    int k_size,
+    const RegionROI* regiones,
+    int num_regiones
+);
+
+#endif // CONVOLUCION_ROI_H
@@ -1,9 +1,39 @@
 #ifndef CONVOLUCION_SECUENCIAL_H
 #define CONVOLUCION_SECUENCIAL_H
 
+#include "layout_planar.h"
+
+/**
+ * Firma común de todos los motores de convolución en CPU.
+ * Permite a main.c elegir el motor (secuencial, SIMD, ...) en tiempo de ejecución.
+ */
+typedef void (*MotorConvolucionCPU)(
+    const unsigned char* input,
+    unsigned char* output,
+    int width,
+    int height,
+    const float* kernel,
+    int k_size
+);
+
+/**
+ * Misma idea con pitch explícito: cada motor tiene su variante _plano que recibe
+ * entrada y salida como PlanoImagen (datos, width, height, pitch), para procesar
+ * filas con relleno o regiones dentro de un frame mayor sin copiarlas.
+ * Entrada y salida no deben solaparse.
+ */
+typedef void (*MotorConvolucionPlano)(
+    const PlanoImagen* entrada,
+    const PlanoImagen* salida,
+    const float* kernel,
+    int k_size
+);
+
 /**
  * Ejecuta la convolución de manera secuencial en la CPU (Single Thread).
- * Recorre la imagen píxel a píxel aplicando la máscara del filtro.
+ * Recorre la imagen fila a fila: el rectángulo interior (donde la máscara
+ * nunca sale de la imagen) usa un kernel sin ramas y el marco de k_size/2
+ * píxeles usa convolucion_pixel() con clamp-to-edge.
  * * @param input     Puntero a los datos de la imagen de entrada (0-255).
  * @param output    Puntero al buffer donde se guardará la imagen procesada.
  * @param width     Ancho de la imagen en píxeles.
@@ -20,6 +50,84 @@ void convolucion_secuencial(
     int k_size
 );
 
-void progreso (int y, int height);
+/**
+ * Igual que convolucion_secuencial() pero solo para las filas [y_ini, y_fin),
+ * sin imprimir progreso. Bandas disjuntas pueden procesarse en paralelo.
+ */
+void convolucion_secuencial_filas(
+    const unsigned char* input,
+    unsigned char* output,
+    int width,
+    int height,
+    const float* kernel,
+    int k_size,
+    int y_ini,
+    int y_fin
+);
+
+/**
+ * Convolución de un plano (datos, pitch): mismo motor que convolucion_secuencial()
+ * pero las filas de entrada y salida pueden tener relleno (pitch > width), por
+ * ejemplo los canales de una ImagenPlanar. Sin progreso ni estadísticas.
+ * @param entrada  Plano de entrada.
+ * @param salida   Plano de salida del mismo width x height; su pitch puede ser otro.
+ */
+void convolucion_secuencial_plano(
+    const PlanoImagen* entrada,
+    const PlanoImagen* salida,
+    const float* kernel,
+    int k_size
+);
+
+// convolucion_secuencial_plano() solo para las filas [y_ini, y_fin)
+void convolucion_secuencial_plano_filas(
+    const PlanoImagen* entrada,
+    const PlanoImagen* salida,
+    const float* kernel,
+    int k_size,
+    int y_ini,
+    int y_fin
+);
+
+/**
+ * Kernel interior sin ramas: calcula los píxeles [x_ini, x_fin) de la fila y.
+ * El llamador garantiza que la ventana completa cae dentro de la imagen:
+ * k_size/2 <= y < height - k_size/2  y  k_size/2 <= x_ini <= x_fin <= width - k_size/2.
+ * Para k_size 3, 5, 7 y 9 despacha a versiones desplegadas en tiempo de compilación.
+ */
+void convolucion_interior(
+    const unsigned char* input,
+    unsigned char* output,
+    int width,
+    const float* kernel,
+    int k_size,
+    int y,
+    int x_ini,
+    int x_fin
+);
+
+/**
+ * Calcula UN píxel de salida (x, y) con manejo de bordes clamp-to-edge.
+ * Es la referencia aritmética de la CPU: los motores optimizados la usan
+ * en los bordes para producir resultados idénticos bit a bit.
+ */
+unsigned char convolucion_pixel(
+    const unsigned char* input,
+    int width,
+    int height,
+    const float* kernel,
+    int k_size,
+    int x,
+    int y
+);
+
+// convolucion_pixel() sobre un plano con pitch
+unsigned char convolucion_pixel_plano(
+    const PlanoImagen* plano,
+    const float* kernel,
+    int k_size,
+    int x,
+    int y
+);
 
 #endif // CONVOLUCION_SEQ_H
\ No newline at end of file
@@ -0,0 +1,33 @@
+#ifndef CONVOLUCION_SEPARABLE_H
+#define CONVOLUCION_SEPARABLE_H
+
+#include "filtro.h"
+#include "layout_planar.h"
+
+/**
+ * Convolución en CPU en dos pasadas 1D (horizontal y luego vertical) para filtros
+ * separables: 2 * k_size taps por píxel en vez de k_size^2. Usa el pool de hilos.
+ * Clamp-to-edge igual que la ruta 2D; el resultado puede diferir en +-1 nivel
+ * respecto a convolucion_secuencial() por el distinto orden de redondeo.
+ * * @param input     Imagen de entrada (0-255).
+ * @param output    Imagen de salida.
+ * @param width     Ancho de la imagen.
+ * @param height    Alto de la imagen.
+ * @param filtro    Filtro ya analizado con filtro_analizar() (debe ser separable).
+ */
+void convolucion_separable(
+    const unsigned char* input,
+    unsigned char* output,
+    int width,
+    int height,
+    const FiltroInfo* filtro
+);
+
+// convolucion_separable() sobre planos con pitch
+void convolucion_separable_plano(
+    const PlanoImagen* entrada,
+    const PlanoImagen* salida,
+    const FiltroInfo* filtro
+);
+
+#endif // CONVOLUCION_SEPARABLE_H
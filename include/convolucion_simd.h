@@ -0,0 +1,98 @@
+#ifndef CONVOLUCION_SIMD_H
+#define CONVOLUCION_SIMD_H
+
+#include "layout_planar.h"
+
+// Conjuntos de instrucciones SIMD que sabe usar el motor vectorizado
+typedef enum {
+    SIMD_ESCALAR = 0,   // Sin SIMD (CPU no x86 o sin SSE4.1)
+    SIMD_SSE41   = 1,   // 8 píxeles por iteración (2 x __m128)
+    SIMD_AVX2    = 2    // 16 píxeles por iteración (2 x __m256)
+} NivelSIMD;
+
+/**
+ * Detecta (una sola vez, vía CPUID) el mejor nivel SIMD soportado por la CPU y el sistema operativo.
+ * Se puede llamar a la vez desde varios hilos: la detección va con pthread_once.
+ */
+NivelSIMD simd_nivel_detectado(void);
+
+// Nombre legible del nivel SIMD (ej. "AVX2")
+const char* simd_nombre(NivelSIMD nivel);
+
+/**
+ * Ejecuta la convolución en la CPU usando instrucciones SIMD (SSE4.1 / AVX2).
+ * Misma firma que convolucion_secuencial() y resultado idéntico bit a bit:
+ * cada carril del vector repite exactamente la secuencia de multiplicaciones
+ * y sumas del código escalar; los bordes se calculan con convolucion_pixel().
+ * * @param input     Puntero a los datos de la imagen de entrada (0-255).
+ * @param output    Puntero al buffer donde se guardará la imagen procesada.
+ * @param width     Ancho de la imagen en píxeles.
+ * @param height    Alto de la imagen en píxeles.
+ * @param kernel    Array de floats con los coeficientes del filtro.
+ * @param k_size    Dimensión del kernel (ej. 3 para una matriz 3x3).
+ */
+void convolucion_simd(
+    const unsigned char* input,
+    unsigned char* output,
+    int width,
+    int height,
+    const float* kernel,
+    int k_size
+);
+
+/**
+ * Igual que convolucion_simd() pero solo para las filas [y_ini, y_fin).
+ * Lee vecinos fuera de ese rango (clamp a la imagen completa), por lo que
+ * varias llamadas sobre bandas disjuntas pueden ejecutarse en paralelo.
+ */
+void convolucion_simd_filas(
+    const unsigned char* input,
+    unsigned char* output,
+    int width,
+    int height,
+    const float* kernel,
+    int k_size,
+    int y_ini,
+    int y_fin
+);
+
+/**
+ * convolucion_simd() sobre planos con pitch (ej. canales de una ImagenPlanar).
+ * Las cargas vectoriales nunca pasan de la columna width - 1: el relleno de
+ * cada fila no se lee ni se escribe.
+ * @param salida  Plano del mismo width x height; su pitch puede ser otro.
+ */
+void convolucion_simd_plano(
+    const PlanoImagen* entrada,
+    const PlanoImagen* salida,
+    const float* kernel,
+    int k_size
+);
+
+// convolucion_simd_plano() solo para las filas [y_ini, y_fin)
+void convolucion_simd_plano_filas(
+    const PlanoImagen* entrada,
+    const PlanoImagen* salida,
+    const float* kernel,
+    int k_size,
+    int y_ini,
+    int y_fin
+);
+
+/**
+ * convolucion_simd_plano() solo para el bloque de píxeles [x_ini, x_fin) x [y_ini, y_fin).
+ * Los vecinos se leen de todo el plano (clamp en los bordes del plano, no del
+ * bloque): el resultado es el mismo que el de la imagen completa en esos píxeles.
+ */
+void convolucion_simd_plano_bloque(
+    const PlanoImagen* entrada,
+    const PlanoImagen* salida,
+    const float* kernel,
+    int k_size,
+    int x_ini,
+    int x_fin,
+    int y_ini,
+    int y_fin
+);
+
+#endif // CONVOLUCION_SIMD_H
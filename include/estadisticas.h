@@ -0,0 +1,20 @@
+#ifndef ESTADISTICAS_H
+#define ESTADISTICAS_H
+
+// Resumen de las repeticiones de una medida (tiempos en ms)
+typedef struct {
+    int n;
+    double min;
+    double mediana;
+    double p95;             // Percentil 95 (rango más cercano)
+    double media;
+    double desviacion;      // Desviación estándar muestral (0 con una sola muestra)
+} Estadisticas;
+
+/**
+ * Calcula el resumen de 'n' muestras. Ordena el array in situ.
+ * @return 1 si hay al menos una muestra, 0 si no.
+ */
+int estadisticas_calcular(double* muestras, int n, Estadisticas* e);
+
+#endif // ESTADISTICAS_H
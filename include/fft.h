@@ -0,0 +1,57 @@
+#ifndef FFT_H
+#define FFT_H
+
+/**
+ * FFT compleja 1D de radix mixto (2, 3, 4, 5) con el esquema de Stockham:
+ * cada paso lee de un buffer y escribe en otro ya en orden, sin permutación
+ * bit-reversal. La misma formulación la usan los kernels fft_paso de OpenCL.
+ */
+
+// Número complejo en precisión simple (mismo layout que float2 en OpenCL)
+typedef struct {
+    float re;
+    float im;
+} Complejo;
+
+// Pasos máximos de un plan (2^32 necesitaría 16 pasos de radix 4)
+#define FFT_MAX_PASOS 32
+
+typedef struct {
+    int n;
+    int num_pasos;
+    int radices[FFT_MAX_PASOS];
+    Complejo* twiddles[FFT_MAX_PASOS];  // Por paso: ns * (radix - 1) factores (sentido directo)
+} PlanFFT;
+
+// Menor tamaño >= n de la forma 2^a * 3^b * 5^c (tamaños para los que hay radix)
+int fft_tamano_rapido(int n);
+
+/**
+ * Descompone n en radices 4, 2, 3 y 5, en el orden en que se aplican.
+ * @return Número de radices, o 0 si n tiene otros factores primos.
+ */
+int fft_factorizar(int n, int* radices);
+
+/**
+ * Prepara el plan (radices y twiddles) para transformadas de tamaño n.
+ * @return 1 si se pudo crear, 0 si n no es 2^a * 3^b * 5^c o falta memoria.
+ */
+int fft_plan_crear(PlanFFT* plan, int n);
+
+void fft_plan_liberar(PlanFFT* plan);
+
+/**
+ * Transforma 'datos' (n elementos) en su sitio, sin escalar.
+ * @param temp      Buffer auxiliar de n elementos.
+ * @param inversa   0 = directa (exp(-i...)), 1 = inversa (exp(+i...)).
+ */
+void fft_ejecutar(const PlanFFT* plan, Complejo* datos, Complejo* temp, int inversa);
+
+/**
+ * Igual que fft_ejecutar() para 'lote' transformadas intercaladas: el elemento i
+ * de la transformada c está en datos[i * lote + c] (ej. un bloque de columnas
+ * copiado fila a fila). temp debe tener n * lote elementos.
+ */
+void fft_ejecutar_lote(const PlanFFT* plan, Complejo* datos, Complejo* temp, int lote, int inversa);
+
+#endif // FFT_H
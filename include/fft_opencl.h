@@ -0,0 +1,36 @@
+#ifndef FFT_OPENCL_H
+#define FFT_OPENCL_H
+
+#include "cl_manager.h"
+
+/**
+ * Convolución por FFT en OpenCL (kernels fft_* de convolucion.cl).
+ * La imagen se extiende con borde replicado y se rellena hasta un tamaño
+ * 2^a 3^b 5^c; las FFT 2D son pasos de Stockham por filas (radix 2/3/4/5)
+ * con una transposición por tiles entre dimensión y dimensión.
+ * Solo encola (no espera): 'filter' debe seguir válido hasta que termine la cadena.
+ * * @param mgr             Gestor OpenCL con el programa ya compilado.
+ * @param d_input         Imagen de entrada en el dispositivo (uchar, width * height).
+ * @param d_output        Resultado en el dispositivo (uchar, saturado).
+ * @param width           Ancho de la imagen.
+ * @param height          Alto de la imagen.
+ * @param filter          Pesos del filtro (host, k_size * k_size).
+ * @param k_size          Tamaño del filtro.
+ * @param primero         Primer kernel encolado (lo libera el llamador).
+ * @param ultimo          Último kernel encolado (lo libera el llamador); el tiempo de GPU
+ *                        es el fin de 'ultimo' menos el inicio de 'primero'.
+ * @return CL_SUCCESS o el primer error de OpenCL (entonces sin eventos que liberar).
+ */
+cl_int fft_opencl_convolucionar(
+    CLManager* mgr,
+    cl_mem d_input,
+    cl_mem d_output,
+    int width,
+    int height,
+    const float* filter,
+    int k_size,
+    cl_event* primero,
+    cl_event* ultimo
+);
+
+#endif // FFT_OPENCL_H
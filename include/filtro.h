@@ -0,0 +1,48 @@
+#ifndef FILTRO_H
+#define FILTRO_H
+
+// Tamaño máximo de filtro que se analiza (más grande = se trata como no separable)
+#define FILTRO_K_MAX 128
+
+// Error relativo máximo (respecto al mayor |peso|) para aceptar K = columna * fila^T
+#define FILTRO_TOLERANCIA_SEPARABLE 1e-5f
+
+// A partir de este tamaño compensa hacer dos pasadas 1D (2k taps) en vez de k^2
+// (por debajo, la ruta 2D especializada/SIMD sigue siendo más rápida)
+#define FILTRO_K_MIN_SEPARABLE 7
+
+// A partir de este tamaño un filtro de caja (todos los pesos iguales) va por sumas
+// acumuladas: coste O(1) por píxel independiente de k_size
+#define FILTRO_K_MIN_CAJA 5
+
+// Por debajo de este tamaño la FFT nunca compensa (ni se calibra el cruce)
+#define FILTRO_K_MIN_FFT 11
+
+/**
+ * Propiedades de un filtro que permiten elegir un algoritmo más barato
+ * que la convolución 2D directa. Se calcula una vez con filtro_analizar().
+ */
+typedef struct {
+    int k_size;
+    int separable;                  // 1 si el filtro tiene rango 1 (dentro de la tolerancia)
+    float fila[FILTRO_K_MAX];       // Pesos de la pasada horizontal (k_size valores)
+    float columna[FILTRO_K_MAX];    // Pesos de la pasada vertical (k_size valores)
+    float error_separable;          // max |K - columna * fila^T|
+    int uniforme;                   // 1 si todos los pesos son iguales (filtro de caja)
+    float peso_uniforme;            // El peso común cuando uniforme == 1
+} FiltroInfo;
+
+/**
+ * Analiza el filtro k_size x k_size: prueba de rango 1 (descomposición
+ * K = columna * fila^T tomando como pivote el peso de mayor magnitud).
+ * @return 1 si el análisis se hizo, 0 si k_size no es válido.
+ */
+int filtro_analizar(const float* pesos, int k_size, FiltroInfo* info);
+
+// 1 si conviene la ruta de dos pasadas 1D para este filtro
+int filtro_usar_separable(const FiltroInfo* info);
+
+// 1 si conviene la ruta de caja (sumas acumuladas); tiene prioridad sobre la separable
+int filtro_usar_caja(const FiltroInfo* info);
+
+#endif // FILTRO_H
@@ -1,12 +1,29 @@
 #ifndef IMAGE_UTILS_H
 #define IMAGE_UTILS_H
 
-// Carga una imagen y devuelve un puntero a los datos (unsigned char)
-// Rellena width, height y channels con los datos de la imagen cargada.
-unsigned char* load_image(const char* filename, int* width, int* height, int* channels);
+// Carga una imagen y devuelve un puntero a los datos (unsigned char, entrelazados)
+// Rellena width, height y channels (canales del archivo) con los datos de la imagen.
+// canales_deseados: 1 = grises, 4 = RGBA, ... (0 = los del archivo).
+unsigned char* load_image(const char* filename, int* width, int* height, int* channels, int canales_deseados);
 
-// Guarda una imagen en formato PNG
-void save_image(const char* filename, int width, int height, unsigned char* data);
+#include <stddef.h>
+
+// Reserva 'bytes' para los píxeles decodificados (ej. memoria pinned de CLManager_AllocHost)
+typedef unsigned char* (*ReservaImagen)(void* contexto, size_t bytes);
+
+// Como load_image, pero deja los píxeles en memoria obtenida con 'reservar'.
+// La liberación corre por cuenta del llamador (no usar free_image).
+unsigned char* load_image_en(const char* filename, int* width, int* height, int* channels,
+                             int canales_deseados, ReservaImagen reservar, void* contexto);
+
+// Guarda una imagen en formato PNG con 'canales' canales entrelazados (1-4)
+void save_image(const char* filename, int width, int height, int canales, const unsigned char* data);
+
+// Guarda datos de 'canales_datos' canales como PNG de 'canales_archivo' canales
+// (ej. RGBA procesado -> RGB original). Al quitar color se usa el canal R, que es
+// el gris cuando la imagen se cargó desde un archivo en grises.
+void save_image_canales(const char* filename, int width, int height, int canales_datos,
+                        int canales_archivo, const unsigned char* data);
 
 // Libera la memoria de la imagen cargada
 void free_image(unsigned char* data);
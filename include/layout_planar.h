@@ -0,0 +1,74 @@
+#ifndef LAYOUT_PLANAR_H
+#define LAYOUT_PLANAR_H
+
+#include <stddef.h>
+
+/**
+ * Conversión entre imágenes entrelazadas (RGBRGB..., como las devuelve stb_image)
+ * y planares (un plano por canal: RRR... GGG... BBB...).
+ *
+ * En planar cada canal es una imagen de un byte por píxel: los motores de un
+ * canal (SIMD en CPU, conv2d en OpenCL) recorren bytes contiguos en vez de
+ * saltar de 'canales' en 'canales'. Las filas de cada plano se rellenan hasta
+ * un 'pitch' múltiplo de PLANAR_ALINEACION bytes, así cada fila empieza alineada
+ * (cargas SIMD alineadas en CPU, accesos coalescidos en la GPU).
+ */
+
+// Alineación de cada fila de plano (una línea de caché / transacción de 64 bytes)
+#define PLANAR_ALINEACION 64
+
+#define PLANAR_MAX_CANALES 4
+
+// Descriptor de un plano de un canal: fila y en datos + y * pitch, 'width' bytes útiles
+typedef struct {
+    unsigned char* datos;
+    int width;
+    int height;
+    size_t pitch;           // Bytes entre el inicio de dos filas (>= width)
+} PlanoImagen;
+
+// Imagen planar: 'canales' planos del mismo tamaño y pitch en un solo bloque alineado
+typedef struct {
+    int width;
+    int height;
+    int canales;
+    size_t pitch;
+    unsigned char* planos[PLANAR_MAX_CANALES];
+    unsigned char* memoria;
+} ImagenPlanar;
+
+// Pitch de un plano de 'width' bytes (redondeado a PLANAR_ALINEACION)
+size_t planar_pitch(int width);
+
+/**
+ * Reserva una imagen planar (relleno a cero).
+ * @return 1 si se pudo reservar, 0 si no.
+ */
+int planar_crear(ImagenPlanar* img, int width, int height, int canales);
+
+void planar_liberar(ImagenPlanar* img);
+
+// Descriptor del plano 'canal' de la imagen
+PlanoImagen planar_plano(const ImagenPlanar* img, int canal);
+
+/**
+ * Separa una imagen entrelazada de img->canales canales (filas contiguas de
+ * width * canales bytes) en los planos de img. Con SSSE3 procesa 16 píxeles
+ * por iteración con pshufb.
+ */
+void planar_desentrelazar(const unsigned char* entrelazada, ImagenPlanar* img);
+
+// Inversa de planar_desentrelazar (mismos shuffles en sentido contrario)
+void planar_entrelazar(const ImagenPlanar* img, unsigned char* entrelazada);
+
+/**
+ * Carga una imagen con los canales del archivo (sin convertir a grises) y la
+ * deja en planar.
+ * @return 1 si se pudo cargar, 0 si no.
+ */
+int planar_cargar(const char* filename, ImagenPlanar* img);
+
+// Reentrelaza y guarda la imagen como PNG con sus canales
+void planar_guardar(const char* filename, const ImagenPlanar* img);
+
+#endif // LAYOUT_PLANAR_H
@@ -0,0 +1,28 @@
+#ifndef PLATAFORMA_H
+#define PLATAFORMA_H
+
+#include <stddef.h>
+
+// x86: intrínsecos disponibles y SIMD_DESTINO(isa) compila una sola función para
+// 'isa' (ej. "avx2"), sin activar -mavx2 en todo el proyecto. MSVC no lo necesita.
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define PLATAFORMA_X86 1
+#include <immintrin.h>
+#if defined(_MSC_VER)
+#define SIMD_DESTINO(isa)
+#else
+#define SIMD_DESTINO(isa) __attribute__((target(isa)))
+#endif
+#endif
+
+/**
+ * Reserva 'bytes' alineados a 'alineacion' (potencia de 2, múltiplo de sizeof(void*)):
+ * _aligned_malloc en Windows, posix_memalign en el resto.
+ * @return El bloque (se libera con liberar_alineado), o NULL si no hay memoria.
+ */
+void* reservar_alineado(size_t bytes, size_t alineacion);
+
+// Libera un bloque de reservar_alineado() (NULL no hace nada)
+void liberar_alineado(void* ptr);
+
+#endif // PLATAFORMA_H
@@ -0,0 +1,43 @@
+#ifndef POOL_HILOS_H
+#define POOL_HILOS_H
+
+/**
+ * Pool de hilos persistente con robo de trabajo (work stealing).
+ *
+ * Un trabajo se describe como N tareas independientes (ej. bandas de filas).
+ * Al lanzar, las tareas se reparten en rangos contiguos, uno por hilo; cada hilo
+ * consume su rango por delante y, cuando se queda sin trabajo, roba la mitad
+ * final del rango de otro hilo. Así los hilos que terminan antes (bandas más
+ * baratas, núcleos menos cargados) no quedan ociosos.
+ */
+
+typedef struct PoolHilos PoolHilos;
+
+// Función que procesa la tarea número 'tarea' del trabajo actual
+typedef void (*TareaPool)(void* contexto, int tarea);
+
+// Número de núcleos lógicos disponibles en la máquina
+int hilos_nucleos_disponibles(void);
+
+/**
+ * Crea el pool. El hilo que llama a pool_ejecutar() también trabaja,
+ * por lo que se crean num_hilos - 1 hilos adicionales.
+ * @param num_hilos  Hilos totales (0 = uno por núcleo lógico).
+ */
+PoolHilos* pool_crear(int num_hilos);
+
+// Pool compartido del proceso (se crea en el primer uso, un hilo por núcleo)
+PoolHilos* pool_global(void);
+
+int pool_num_hilos(const PoolHilos* pool);
+
+/**
+ * Ejecuta las tareas [0, num_tareas) repartidas entre los hilos del pool
+ * y bloquea hasta que todas terminan. Llamadas concurrentes se serializan.
+ */
+void pool_ejecutar(PoolHilos* pool, int num_tareas, TareaPool funcion, void* contexto);
+
+// Detiene los hilos y libera el pool
+void pool_destruir(PoolHilos* pool);
+
+#endif // POOL_HILOS_H
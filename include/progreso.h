@@ -0,0 +1,26 @@
+#ifndef PROGRESO_H
+#define PROGRESO_H
+
+#include <stdatomic.h>
+
+/**
+ * Contador de progreso de UNA llamada de convolución.
+ * Cada motor declara el suyo (en la pila), así que varias convoluciones
+ * pueden correr a la vez; los hilos avanzan el contador de forma atómica.
+ */
+typedef struct {
+    atomic_int filas_hechas;        // Filas terminadas hasta ahora
+    atomic_int ultimo_porcentaje;   // Último múltiplo de 10 impreso
+    int total_filas;
+} Progreso;
+
+// Reinicia el contador para una imagen de 'total_filas' filas
+void progreso_iniciar(Progreso* p, int total_filas);
+
+// Suma 'filas' terminadas e imprime cada 10% alcanzado (seguro entre hilos)
+void progreso_avanzar(Progreso* p, int filas);
+
+// Cierra la línea de progreso (imprime el 100% si faltaba)
+void progreso_finalizar(Progreso* p);
+
+#endif // PROGRESO_H
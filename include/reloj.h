@@ -0,0 +1,8 @@
+#ifndef RELOJ_H
+#define RELOJ_H
+
+// Reloj monotónico de alta resolución en milisegundos (origen arbitrario):
+// QueryPerformanceCounter en Windows, CLOCK_MONOTONIC en el resto
+double reloj_ms(void);
+
+#endif // RELOJ_H
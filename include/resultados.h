@@ -0,0 +1,59 @@
+#ifndef RESULTADOS_H
+#define RESULTADOS_H
+
+#include <stddef.h>
+
+#include "estadisticas.h"
+
+// Una medida: motor y fase en un punto (imagen, filtro) del benchmark
+typedef struct {
+    char motor[32];
+    char fase[16];
+    int width;
+    int height;
+    int k_size;
+    char filtro[16];
+    Estadisticas e;
+    double bytes;           // Bytes movidos por la fase (para GB/s)
+} FilaBench;
+
+// Tabla de medidas que crece según se agregan filas
+typedef struct {
+    FilaBench* filas;
+    int num_filas;
+    int capacidad;
+} TablaBench;
+
+void tabla_iniciar(TablaBench* tabla);
+void tabla_liberar(TablaBench* tabla);
+
+/**
+ * Agrega una fila con el resumen de 'n' muestras (las ordena in situ).
+ * @return 1 si se agregó, 0 si no hay memoria.
+ */
+int tabla_agregar(TablaBench* tabla, const char* motor, const char* fase, int width, int height,
+                  int k_size, const char* filtro, double* muestras, int n, double bytes);
+
+// Throughput con la mediana (0 si la fase no tardó nada, ej. subida zero-copy)
+double fila_mpx_s(const FilaBench* fila);
+double fila_gb_s(const FilaBench* fila);
+
+// Tabla legible en stdout, una fila por motor y fase
+void tabla_imprimir(const TablaBench* tabla);
+
+/**
+ * Escribe la tabla en CSV (cabecera + una línea por fila) o en JSON
+ * ({"resultados": [...]} con un objeto por línea).
+ * @return 1 si se escribió, 0 si no se pudo abrir el archivo.
+ */
+int tabla_escribir_csv(const TablaBench* tabla, const char* ruta);
+int tabla_escribir_json(const TablaBench* tabla, const char* ruta);
+
+/**
+ * Lee un archivo escrito por tabla_escribir_json (un objeto por línea) y agrega
+ * sus filas a la tabla. Las líneas sin "motor" se ignoran.
+ * @return Número de filas leídas, o -1 si no se pudo abrir el archivo.
+ */
+int tabla_leer_json(TablaBench* tabla, const char* ruta);
+
+#endif // RESULTADOS_H
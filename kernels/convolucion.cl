@@ -1,12 +1,33 @@
 // kernels/convolucion.cl
 
+// Especialización (CLManager_GetKernelVariante): compilado con -D KSIZE=n, conv2d,
+// conv2d_interior, conv2d_borde, conv2d_tiles, conv2d_bloques y conv2d_imagen usan n
+// en lugar del argumento ksize, los límites de los bucles son constantes y el
+// compilador puede desenrollarlos. Con -D PESOS=p0,p1,... (k*k
+// literales float) los pesos salen además de una tabla constante del programa en
+// lugar del buffer kdata. Las sumas se hacen en el mismo orden: resultado idéntico.
+#ifdef KSIZE
+#define KSIZE_CONV KSIZE
+#else
+#define KSIZE_CONV ksize
+#endif
+
+#ifdef PESOS
+__constant float pesos_fijos[KSIZE * KSIZE] = { PESOS };
+#define PESO_CONV(i) pesos_fijos[i]
+#else
+#define PESO_CONV(i) kdata[i]
+#endif
+
 __kernel void conv2d(
-    __global const float* input,    // Imagen de entrada (linealizada)
-    __global float* output,         // Imagen de salida (linealizada)
+    __global const uchar* input,    // Imagen de entrada (linealizada, 0-255)
+    __global uchar* output,         // Imagen de salida (linealizada, saturada a 0-255)
     __constant float* kdata,        // La matriz del filtro (Kernel 3x3, 5x5, etc)
     int width,                      // Ancho de la imagen
     int height,                     // Alto de la imagen
-    int ksize                       // Tamaño del filtro (ej. 3)
+    int ksize,                      // Tamaño del filtro (ej. 3)
+    int pitch_entrada,              // Elementos entre dos filas de input (>= width; width si son contiguas)
+    int pitch_salida                // Elementos entre dos filas de output
 )
 {
     // 1. Obtener las coordenadas del pixel que este hilo va a procesar
@@ -17,7 +38,7 @@ __kernel void conv2d(
     if (gx >= width || gy >= height) return;
 
     // 3. Inicializar acumulador
-    int khalf = ksize / 2;
+    int khalf = KSIZE_CONV / 2;
     float sum = 0.0f; //
 
     // 4. Convolución: Iterar sobre la ventana del filtro
@@ -36,13 +57,634 @@ __kernel void conv2d(
             if (iy >= height) iy = height - 1; //
 
             // Leer valor del pixel y peso del filtro
-            float pixel = input[iy * width + ix];
-            float weight = kdata[(ky + khalf) * ksize + (kx + khalf)]; //
+            float pixel = (float)input[iy * pitch_entrada + ix];
+            float weight = PESO_CONV((ky + khalf) * KSIZE_CONV + (kx + khalf)); //
 
             sum += pixel * weight;
         }
     }
 
     // 5. Escribir el resultado final en la posición global
-    output[gy * width + gx] = sum; //
-}
\ No newline at end of file
+    // Saturación a [0, 255] con truncamiento (igual que la versión de CPU)
+    output[gy * pitch_salida + gx] = convert_uchar_sat(sum);
+}
+
+// División interior / borde de conv2d: en el rectángulo interior [khalf, width - khalf)
+// x [khalf, height - khalf) la ventana entera cae dentro de la imagen y no hace falta
+// el clamp de cada tap (sin ramas ni divergencia, y los runtimes de CPU pueden
+// vectorizar el bucle). El host lanza conv2d_interior sobre ese rectángulo con
+// global_work_offset = (khalf, khalf) y conv2d_borde sobre las cuatro franjas que
+// quedan. Mismos argumentos y mismo orden de sumas que conv2d: resultado idéntico.
+__kernel void conv2d_interior(
+    __global const uchar* input,
+    __global uchar* output,
+    __constant float* kdata,
+    int width,
+    int height,
+    int ksize,
+    int pitch_entrada,
+    int pitch_salida
+)
+{
+    int gx = (int)get_global_id(0);
+    int gy = (int)get_global_id(1);
+    int khalf = KSIZE_CONV / 2;
+
+    // El global puede venir redondeado a múltiplo del work-group
+    if (gx >= width - khalf || gy >= height - khalf) return;
+
+    __global const uchar* ventana = input + (gy - khalf) * pitch_entrada + (gx - khalf);
+    float sum = 0.0f;
+    for (int ky = 0; ky < KSIZE_CONV; ky++) {
+        for (int kx = 0; kx < KSIZE_CONV; kx++) {
+            sum += (float)ventana[kx] * PESO_CONV(ky * KSIZE_CONV + kx);
+        }
+        ventana += pitch_entrada;
+    }
+
+    output[gy * pitch_salida + gx] = convert_uchar_sat(sum);
+}
+
+// Franjas de borde: khalf filas arriba y abajo (completas) y khalf columnas a cada
+// lado en las filas del interior. NDRange 1D con un work-item por píxel de franja
+// (el host lanza exactamente ese número); si la imagen mide menos de 2 * khalf + 1
+// de lado, las franjas cubren la imagen entera.
+__kernel void conv2d_borde(
+    __global const uchar* input,
+    __global uchar* output,
+    __constant float* kdata,
+    int width,
+    int height,
+    int ksize,
+    int pitch_entrada,
+    int pitch_salida
+)
+{
+    int khalf = KSIZE_CONV / 2;
+    int arriba = min(khalf, height);
+    int abajo = min(khalf, height - arriba);
+    int izquierda = min(khalf, width);
+    int derecha = min(khalf, width - izquierda);
+    int filas_interior = height - arriba - abajo;
+    int laterales = izquierda + derecha;
+
+    // 1. Índice del work-item -> píxel (gx, gy): primero las filas de arriba y abajo,
+    //    después las columnas laterales fila a fila
+    int i = (int)get_global_id(0);
+    int gx, gy;
+    if (i < (arriba + abajo) * width) {
+        gy = i / width;
+        gx = i % width;
+        if (gy >= arriba) gy += filas_interior;
+    } else {
+        i -= (arriba + abajo) * width;
+        if (i >= filas_interior * laterales) return;
+        gy = arriba + i / laterales;
+        gx = i % laterales;
+        if (gx >= izquierda) gx += width - laterales;
+    }
+
+    // 2. Convolución con clamp-to-edge, como conv2d
+    float sum = 0.0f;
+    for (int ky = -khalf; ky <= khalf; ky++) {
+        __global const uchar* fila = input + clamp(gy + ky, 0, height - 1) * pitch_entrada;
+        for (int kx = -khalf; kx <= khalf; kx++) {
+            float pixel = (float)fila[clamp(gx + kx, 0, width - 1)];
+            sum += pixel * PESO_CONV((ky + khalf) * KSIZE_CONV + (kx + khalf));
+        }
+    }
+
+    output[gy * pitch_salida + gx] = convert_uchar_sat(sum);
+}
+
+// Variante por tiles de conv2d: cada work-group carga una sola vez en memoria local
+// su bloque de (get_local_size + ksize - 1)^2 píxeles (tile + halo, con clamp-to-edge)
+// y calcula desde ahí. En conv2d cada píxel se lee de __global hasta ksize^2 veces.
+// El host lanza un global múltiplo del tamaño local, así que todos los work-items
+// participan en la carga y en la barrera; solo escriben los que caen en la imagen.
+// Mismo orden de sumas que conv2d: resultado idéntico.
+__kernel void conv2d_tiles(
+    __global const uchar* input,
+    __global uchar* output,
+    __constant float* kdata,
+    __local float* tile,            // (get_local_size(0) + ksize - 1) * (get_local_size(1) + ksize - 1)
+    int width,
+    int height,
+    int ksize,
+    int pitch_entrada,              // Elementos entre filas, como en conv2d
+    int pitch_salida
+)
+{
+    int lx = (int)get_local_id(0);
+    int ly = (int)get_local_id(1);
+    int tile_w = (int)get_local_size(0);
+    int tile_h = (int)get_local_size(1);
+    int khalf = KSIZE_CONV / 2;
+
+    // 1. Carga cooperativa del tile con halo
+    int lado_x = tile_w + KSIZE_CONV - 1;
+    int lado_y = tile_h + KSIZE_CONV - 1;
+    int origen_x = (int)get_group_id(0) * tile_w - khalf;
+    int origen_y = (int)get_group_id(1) * tile_h - khalf;
+
+    for (int i = ly * tile_w + lx; i < lado_x * lado_y; i += tile_w * tile_h) {
+        int ix = clamp(origen_x + i % lado_x, 0, width - 1);
+        int iy = clamp(origen_y + i / lado_x, 0, height - 1);
+        tile[i] = (float)input[iy * pitch_entrada + ix];
+    }
+    barrier(CLK_LOCAL_MEM_FENCE);
+
+    // 2. Convolución desde memoria local
+    int gx = (int)get_global_id(0);
+    int gy = (int)get_global_id(1);
+    if (gx >= width || gy >= height) return;
+
+    float sum = 0.0f;
+    for (int ky = 0; ky < KSIZE_CONV; ky++) {
+        for (int kx = 0; kx < KSIZE_CONV; kx++) {
+            sum += tile[(ly + ky) * lado_x + lx + kx] * PESO_CONV(ky * KSIZE_CONV + kx);
+        }
+    }
+
+    output[gy * pitch_salida + gx] = convert_uchar_sat(sum);
+}
+
+// Register blocking: cada work-item calcula un bloque de BLOQUE_X x BLOQUE_Y píxeles
+// (BLOQUE_X = 4 u 8, un vector por fila del bloque; el host lo fija con -D al
+// compilar la variante). Cada fila de entrada del bloque se recorre una sola vez y
+// cada lectura vectorial de BLOQUE_X vecinos sirve a los BLOQUE_X píxeles de la fila
+// y a todas las filas del bloque que usan esa fila del filtro. El host lanza un
+// work-item por bloque. Mismo orden de sumas por píxel que conv2d: resultado idéntico.
+#ifndef BLOQUE_X
+#define BLOQUE_X 4
+#endif
+#ifndef BLOQUE_Y
+#define BLOQUE_Y 1
+#endif
+
+#define PEGAR_(a, b) a##b
+#define PEGAR(a, b) PEGAR_(a, b)
+#define float_bloque PEGAR(float, BLOQUE_X)
+#define uchar_bloque PEGAR(uchar, BLOQUE_X)
+#define vload_bloque PEGAR(vload, BLOQUE_X)
+#define vstore_bloque PEGAR(vstore, BLOQUE_X)
+#define convert_float_bloque PEGAR(convert_float, BLOQUE_X)
+#define convert_uchar_bloque_sat PEGAR(PEGAR(convert_uchar, BLOQUE_X), _sat)
+
+__kernel void conv2d_bloques(
+    __global const uchar* input,
+    __global uchar* output,
+    __constant float* kdata,
+    int width,
+    int height,
+    int ksize,
+    int pitch_entrada,              // Elementos entre filas, como en conv2d
+    int pitch_salida
+)
+{
+    int x0 = (int)get_global_id(0) * BLOQUE_X;
+    int y0 = (int)get_global_id(1) * BLOQUE_Y;
+    if (x0 >= width || y0 >= height) return;
+
+    int khalf = KSIZE_CONV / 2;
+    float_bloque sum[BLOQUE_Y];
+    for (int j = 0; j < BLOQUE_Y; j++) sum[j] = (float_bloque)(0.0f);
+
+    // 1. Cada fila de entrada que toca el bloque, una vez
+    for (int r = 0; r < BLOQUE_Y + KSIZE_CONV - 1; r++) {
+        int iy = clamp(y0 - khalf + r, 0, height - 1);
+        __global const uchar* fila = input + iy * pitch_entrada;
+
+        for (int kx = 0; kx < KSIZE_CONV; kx++) {
+            // 2. BLOQUE_X vecinos consecutivos en un vector (clamp solo en los bordes)
+            int ix = x0 - khalf + kx;
+            float_bloque v;
+            if (ix >= 0 && ix + BLOQUE_X <= width) {
+                v = convert_float_bloque(vload_bloque(0, fila + ix));
+            } else {
+                float p[BLOQUE_X];
+                for (int i = 0; i < BLOQUE_X; i++) p[i] = (float)fila[clamp(ix + i, 0, width - 1)];
+                v = vload_bloque(0, p);
+            }
+
+            // 3. El vector sirve a cada fila del bloque que usa esta fila del filtro
+            for (int j = 0; j < BLOQUE_Y; j++) {
+                int ky = r - j;
+                if (ky >= 0 && ky < KSIZE_CONV) sum[j] += v * PESO_CONV(ky * KSIZE_CONV + kx);
+            }
+        }
+    }
+
+    // 4. Escritura vectorial si el bloque cabe entero en la fila
+    for (int j = 0; j < BLOQUE_Y && y0 + j < height; j++) {
+        __global uchar* destino = output + (y0 + j) * pitch_salida + x0;
+        uchar_bloque resultado = convert_uchar_bloque_sat(sum[j]);
+        if (x0 + BLOQUE_X <= width) {
+            vstore_bloque(resultado, 0, destino);
+        } else {
+            uchar p[BLOQUE_X];
+            vstore_bloque(resultado, 0, p);
+            for (int i = 0; i < width - x0; i++) destino[i] = p[i];
+        }
+    }
+}
+
+// Variante con imágenes: la entrada es una image2d_t CL_R / CL_UNORM_INT8 leída con
+// un sampler CLK_ADDRESS_CLAMP_TO_EDGE, así que el clamp a los bordes y la conversión
+// uchar -> float los hace la unidad de texturas (sin ramas por tap). read_imagef
+// devuelve v / 255 con hasta 1,5 ulp de error: al reescalar, la suma puede diferir de
+// la de conv2d y algún píxel quedar una unidad por debajo o por encima. La salida es
+// otra imagen CL_R / CL_UNORM_INT8; se escribe trunc(sum) / 255 para que la conversión
+// de vuelta a 8 bits dé el mismo valor que convert_uchar_sat.
+__constant sampler_t muestreo_borde = CLK_NORMALIZED_COORDS_FALSE | CLK_ADDRESS_CLAMP_TO_EDGE | CLK_FILTER_NEAREST;
+
+__kernel void conv2d_imagen(
+    __read_only image2d_t entrada,
+    __write_only image2d_t salida,
+    __constant float* kdata,
+    int ksize
+)
+{
+    int gx = (int)get_global_id(0);
+    int gy = (int)get_global_id(1);
+    if (gx >= get_image_width(salida) || gy >= get_image_height(salida)) return;
+
+    int khalf = KSIZE_CONV / 2;
+    float sum = 0.0f;
+    for (int ky = -khalf; ky <= khalf; ky++) {
+        for (int kx = -khalf; kx <= khalf; kx++) {
+            float pixel = read_imagef(entrada, muestreo_borde, (int2)(gx + kx, gy + ky)).x * 255.0f;
+            sum += pixel * PESO_CONV((ky + khalf) * KSIZE_CONV + (kx + khalf));
+        }
+    }
+
+    float valor = clamp(trunc(sum), 0.0f, 255.0f);
+    write_imagef(salida, (int2)(gx, gy), (float4)(valor / 255.0f, 0.0f, 0.0f, 1.0f));
+}
+
+// Color: RGBA entrelazado, un uchar4 por píxel. Mismas sumas que conv2d en cada
+// canal (float4), con una sola lectura de 4 bytes por tap.
+// Con filtrar_alpha = 0 el canal alfa se copia de la entrada sin filtrar.
+__kernel void conv2d_rgba(
+    __global const uchar4* input,
+    __global uchar4* output,
+    __constant float* kdata,
+    int width,
+    int height,
+    int ksize,
+    int filtrar_alpha
+)
+{
+    int gx = (int)get_global_id(0);
+    int gy = (int)get_global_id(1);
+    if (gx >= width || gy >= height) return;
+
+    int khalf = ksize / 2;
+    float4 sum = (float4)(0.0f);
+
+    for (int ky = -khalf; ky <= khalf; ky++) {
+        int iy = clamp(gy + ky, 0, height - 1);
+        for (int kx = -khalf; kx <= khalf; kx++) {
+            int ix = clamp(gx + kx, 0, width - 1);
+            float weight = kdata[(ky + khalf) * ksize + (kx + khalf)];
+            sum += convert_float4(input[iy * width + ix]) * weight;
+        }
+    }
+
+    uchar4 resultado = convert_uchar4_sat(sum);
+    if (!filtrar_alpha) resultado.w = input[gy * width + gx].w;
+    output[gy * width + gx] = resultado;
+}
+
+// Filtros separables (K = columna * fila^T): dos pasadas 1D de ksize taps cada una.
+// Pasada horizontal (uchar -> float intermedio): clamp solo en X.
+__kernel void conv_fila(
+    __global const uchar* input,
+    __global float* output,
+    __constant float* pesos,        // ksize pesos de la fila
+    int width,
+    int height,
+    int ksize
+)
+{
+    int gx = (int)get_global_id(0);
+    int gy = (int)get_global_id(1);
+    if (gx >= width || gy >= height) return;
+
+    int khalf = ksize / 2;
+    __global const uchar* fila = input + gy * width;
+    float sum = 0.0f;
+
+    for (int k = -khalf; k <= khalf; k++) {
+        int ix = clamp(gx + k, 0, width - 1);
+        sum += (float)fila[ix] * pesos[k + khalf];
+    }
+
+    output[gy * width + gx] = sum;
+}
+
+// Pasada vertical (float intermedio -> uchar saturado): clamp solo en Y.
+__kernel void conv_columna(
+    __global const float* input,
+    __global uchar* output,
+    __constant float* pesos,        // ksize pesos de la columna
+    int width,
+    int height,
+    int ksize
+)
+{
+    int gx = (int)get_global_id(0);
+    int gy = (int)get_global_id(1);
+    if (gx >= width || gy >= height) return;
+
+    int khalf = ksize / 2;
+    float sum = 0.0f;
+
+    for (int k = -khalf; k <= khalf; k++) {
+        int iy = clamp(gy + k, 0, height - 1);
+        sum += input[iy * width + gx] * pesos[k + khalf];
+    }
+
+    output[gy * width + gx] = convert_uchar_sat(sum);
+}
+
+
+// Filtro de caja (todos los pesos iguales), O(1) por píxel.
+// Paso 1: un work-group por fila. Calcula la suma prefija de la fila con un scan
+// en memoria local (por tramos de get_local_size(0) píxeles, arrastrando el total)
+// y de ella la suma de la ventana horizontal con clamp-to-edge:
+//   H(x) = P[min(x+h, w-1)] - P[max(x-h, 0) - 1] + pixeles repetidos de los bordes
+// Las sumas son enteras (exactas) porque la entrada viene de uchar.
+__kernel void caja_filas(
+    __global const uchar* input,
+    __global uint* prefijo,         // width * height, suma prefija por fila (scratch)
+    __global uint* horizontal,      // width * height, suma de la ventana horizontal
+    __local uint* scan,             // get_local_size(0) elementos
+    int width,
+    int height,
+    int ksize
+)
+{
+    int lid = (int)get_local_id(0);
+    int lsize = (int)get_local_size(0);
+    int gy = (int)get_group_id(1);
+    if (gy >= height) return;
+
+    __global const uchar* fila = input + gy * width;
+    __global uint* pref = prefijo + gy * width;
+    uint arrastre = 0;
+
+    // 1. Scan inclusivo por tramos (Hillis-Steele en memoria local)
+    for (int base = 0; base < width; base += lsize) {
+        int x = base + lid;
+        scan[lid] = x < width ? (uint)fila[x] : 0u;
+        barrier(CLK_LOCAL_MEM_FENCE);
+
+        for (int d = 1; d < lsize; d <<= 1) {
+            uint v = lid >= d ? scan[lid - d] : 0u;
+            barrier(CLK_LOCAL_MEM_FENCE);
+            scan[lid] += v;
+            barrier(CLK_LOCAL_MEM_FENCE);
+        }
+
+        if (x < width) pref[x] = arrastre + scan[lid];
+        arrastre += scan[lsize - 1];
+        barrier(CLK_LOCAL_MEM_FENCE);
+    }
+
+    // La fila completa de prefijos es visible para todo el grupo
+    barrier(CLK_GLOBAL_MEM_FENCE);
+
+    // 2. Ventana horizontal desde los prefijos
+    int khalf = ksize / 2;
+    uint borde_izq = (uint)fila[0];
+    uint borde_der = (uint)fila[width - 1];
+
+    for (int x = lid; x < width; x += lsize) {
+        int lo = x - khalf;
+        int hi = x + khalf;
+        uint suma = pref[min(hi, width - 1)] - (lo > 0 ? pref[lo - 1] : 0u);
+        if (lo < 0) suma += (uint)(-lo) * borde_izq;
+        if (hi > width - 1) suma += (uint)(hi - (width - 1)) * borde_der;
+        horizontal[gy * width + x] = suma;
+    }
+}
+
+// Paso 2: ventana vertical deslizante. Cada work-item recorre un tramo de
+// 'filas_por_item' filas de una columna: work-items vecinos leen columnas
+// contiguas (accesos coalescentes) y cada píxel cuesta una suma y una resta.
+__kernel void caja_columnas(
+    __global const uint* horizontal,
+    __global uchar* output,
+    float peso,                     // Peso común de los ksize * ksize coeficientes
+    int width,
+    int height,
+    int ksize,
+    int filas_por_item
+)
+{
+    int gx = (int)get_global_id(0);
+    int y_ini = (int)get_global_id(1) * filas_por_item;
+    if (gx >= width || y_ini >= height) return;
+
+    int y_fin = min(y_ini + filas_por_item, height);
+    int khalf = ksize / 2;
+
+    // 1. Ventana inicial (clamp-to-edge en Y)
+    uint suma = 0;
+    for (int k = -khalf; k <= khalf; k++) {
+        suma += horizontal[clamp(y_ini + k, 0, height - 1) * width + gx];
+    }
+
+    // 2. Deslizar hacia abajo
+    for (int y = y_ini; y < y_fin; y++) {
+        output[y * width + gx] = convert_uchar_sat((float)suma * peso);
+        suma += horizontal[min(y + khalf + 1, height - 1) * width + gx];
+        suma -= horizontal[max(y - khalf, 0) * width + gx];
+    }
+}
+
+
+// ============================================
+// Convolución por FFT (filtros grandes)
+// ============================================
+// Datos complejos como float2 (x = real, y = imaginaria). Las transformadas 2D
+// son FFT por filas + transposición + FFT por filas (Stockham, radix 2/3/4/5).
+
+// Lado del tile de fft_transponer (el host lanza work-groups de FFT_TILE x FFT_TILE)
+#define FFT_TILE 16
+
+inline float2 cmul(float2 a, float2 b) {
+    return (float2)(a.x * b.x - a.y * b.y, a.x * b.y + a.y * b.x);
+}
+
+// Imagen extendida con borde replicado (clamp-to-edge) y relleno de ceros hasta nx x ny
+__kernel void fft_extender(
+    __global const uchar* input,
+    __global float2* datos,
+    int width,
+    int height,
+    int khalf,
+    int nx,
+    int ny
+)
+{
+    int gx = (int)get_global_id(0);
+    int gy = (int)get_global_id(1);
+    if (gx >= nx || gy >= ny) return;
+
+    float v = 0.0f;
+    if (gx < width + 2 * khalf && gy < height + 2 * khalf) {
+        int ix = clamp(gx - khalf, 0, width - 1);
+        int iy = clamp(gy - khalf, 0, height - 1);
+        v = (float)input[iy * width + ix];
+    }
+    datos[gy * nx + gx] = (float2)(v, 0.0f);
+}
+
+// Filtro volteado y centrado en el origen: G[(h - i) mod ny][(h - j) mod nx] = K[i][j]
+__kernel void fft_colocar_filtro(
+    __global const float* kdata,
+    __global float2* datos,
+    int ksize,
+    int nx,
+    int ny
+)
+{
+    int gx = (int)get_global_id(0);
+    int gy = (int)get_global_id(1);
+    if (gx >= nx || gy >= ny) return;
+
+    int khalf = ksize / 2;
+    int i = ((khalf - gy) % ny + ny) % ny;
+    int j = ((khalf - gx) % nx + nx) % nx;
+
+    float v = (i < ksize && j < ksize) ? kdata[i * ksize + j] : 0.0f;
+    datos[gy * nx + gx] = (float2)(v, 0.0f);
+}
+
+// Un paso de Stockham sobre cada fila (get_global_id(1)) de n elementos:
+// cada work-item hace una mariposa de 'radix' puntos. ns = producto de las
+// radices ya aplicadas. inversa = 0 usa exp(-i...), 1 usa exp(+i...).
+__kernel void fft_paso(
+    __global const float2* src,
+    __global float2* dst,
+    int n,
+    int radix,
+    int ns,
+    int inversa
+)
+{
+    int j = (int)get_global_id(0);
+    int fila = (int)get_global_id(1);
+    int m = n / radix;
+    if (j >= m) return;
+
+    src += fila * n;
+    dst += fila * n;
+
+    int k = j % ns;
+    float signo = inversa ? 1.0f : -1.0f;
+    float ang = signo * 2.0f * M_PI_F * (float)k / (float)(ns * radix);
+
+    // 1. Cargar con paso n / radix y aplicar twiddles
+    float2 v[5];
+    v[0] = src[j];
+    for (int r = 1; r < radix; r++) {
+        float2 w = (float2)(cos(ang * r), sin(ang * r));
+        v[r] = cmul(src[j + r * m], w);
+    }
+
+    // 2. Mariposa
+    if (radix == 2) {
+        float2 a = v[0];
+        v[0] = a + v[1];
+        v[1] = a - v[1];
+    } else if (radix == 4) {
+        float2 a = v[0] + v[2];
+        float2 b = v[0] - v[2];
+        float2 c = v[1] + v[3];
+        float2 d = v[1] - v[3];
+        float2 di = (float2)(-signo * d.y, signo * d.x);
+        v[0] = a + c;
+        v[1] = b + di;
+        v[2] = a - c;
+        v[3] = b - di;
+    } else if (radix == 3) {
+        const float s3 = 0.86602540378443864676f;
+        float2 a = v[1] + v[2];
+        float2 b = v[0] - 0.5f * a;
+        float2 c = (float2)(-signo * s3 * (v[1].y - v[2].y), signo * s3 * (v[1].x - v[2].x));
+        v[0] = v[0] + a;
+        v[1] = b + c;
+        v[2] = b - c;
+    } else {
+        // Radix 5: DFT directa
+        float2 e[5];
+        for (int r = 0; r < 5; r++) e[r] = v[r];
+        for (int s = 0; s < 5; s++) {
+            float2 acc = (float2)(0.0f, 0.0f);
+            for (int r = 0; r < 5; r++) {
+                float a5 = signo * 2.0f * M_PI_F * (float)((r * s) % 5) / 5.0f;
+                acc += cmul(e[r], (float2)(cos(a5), sin(a5)));
+            }
+            v[s] = acc;
+        }
+    }
+
+    // 3. Escribir ya ordenado
+    int base = (j / ns) * ns * radix + k;
+    for (int r = 0; r < radix; r++) dst[base + r * ns] = v[r];
+}
+
+// Transposición por tiles en memoria local (lecturas y escrituras coalescentes).
+// src tiene 'alto' filas de 'ancho' elementos; dst queda con 'ancho' filas de 'alto'.
+__kernel void fft_transponer(
+    __global const float2* src,
+    __global float2* dst,
+    int ancho,
+    int alto
+)
+{
+    __local float2 tile[FFT_TILE][FFT_TILE + 1];   // +1 evita conflictos de bancos
+
+    int lx = (int)get_local_id(0);
+    int ly = (int)get_local_id(1);
+    int bx = (int)get_group_id(0) * FFT_TILE;
+    int by = (int)get_group_id(1) * FFT_TILE;
+
+    if (bx + lx < ancho && by + ly < alto) tile[ly][lx] = src[(by + ly) * ancho + bx + lx];
+    barrier(CLK_LOCAL_MEM_FENCE);
+
+    if (by + lx < alto && bx + ly < ancho) dst[(bx + ly) * alto + by + lx] = tile[lx][ly];
+}
+
+// Producto punto a punto de espectros: a *= b
+__kernel void fft_multiplicar(
+    __global float2* a,
+    __global const float2* b,
+    int n
+)
+{
+    int i = (int)get_global_id(0);
+    if (i >= n) return;
+    a[i] = cmul(a[i], b[i]);
+}
+
+// Parte real escalada de la zona útil (sin la extensión de bordes), saturada a uchar
+__kernel void fft_recortar(
+    __global const float2* datos,
+    __global uchar* output,
+    int width,
+    int height,
+    int khalf,
+    int nx,
+    float escala
+)
+{
+    int gx = (int)get_global_id(0);
+    int gy = (int)get_global_id(1);
+    if (gx >= width || gy >= height) return;
+
+    output[gy * width + gx] = convert_uchar_sat(datos[(gy + khalf) * nx + gx + khalf].x * escala);
+}
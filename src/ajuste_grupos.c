@@ -0,0 +1,168 @@
+#include "ajuste_grupos.h"
+#include "cache_programas.h"
+
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef _WIN32
+#include <direct.h>
+#define crear_directorio(ruta) _mkdir(ruta)
+#else
+#include <sys/stat.h>
+#define crear_directorio(ruta) mkdir(ruta, 0755)
+#endif
+
+typedef struct {
+    char dispositivo[128];
+    char variante[32];
+    int clase;
+    int k_size;
+    size_t local[2];
+    double ms;
+} EntradaAjuste;
+
+// Copia en memoria del archivo (se carga una vez por proceso). El mutex protege
+// la copia y la reescritura del archivo: se puede ajustar y lanzar desde varios hilos
+static EntradaAjuste entradas[AJUSTE_MAX_ENTRADAS];
+static int num_entradas = 0;
+static int cargado = 0;
+static pthread_mutex_t mutex_ajuste = PTHREAD_MUTEX_INITIALIZER;
+
+static const char* directorio_ajuste(void) {
+    const char* dir = getenv("CL_CACHE_DIR");
+    return (dir && dir[0]) ? dir : CACHE_PROGRAMAS_DIR;
+}
+
+static void ruta_ajuste(char* ruta, size_t max) {
+    snprintf(ruta, max, "%s/%s", directorio_ajuste(), AJUSTE_ARCHIVO);
+}
+
+// El nombre del dispositivo es la clave (tabuladores y saltos de línea se reemplazan)
+static void nombre_dispositivo(cl_device_id device, char* nombre, size_t max) {
+    nombre[0] = '\0';
+    clGetDeviceInfo(device, CL_DEVICE_NAME, max, nombre, NULL);
+    nombre[max - 1] = '\0';
+    for (char* c = nombre; *c; c++) {
+        if (*c == '\t' || *c == '\n' || *c == '\r') *c = ' ';
+    }
+}
+
+// Formato: dispositivo \t variante \t clase \t k \t local_x \t local_y \t ms
+// (con mutex_ajuste tomado)
+static void cargar_archivo(void) {
+    cargado = 1;
+    char ruta[512];
+    ruta_ajuste(ruta, sizeof(ruta));
+    FILE* fp = fopen(ruta, "r");
+    if (!fp) return;
+
+    char linea[512];
+    while (num_entradas < AJUSTE_MAX_ENTRADAS && fgets(linea, sizeof(linea), fp)) {
+        if (linea[0] == '#') continue;
+        EntradaAjuste* e = &entradas[num_entradas];
+        char* campos[7];
+        int n = 0;
+        for (char* c = strtok(linea, "\t\r\n"); c && n < 7; c = strtok(NULL, "\t\r\n")) campos[n++] = c;
+        if (n != 7) continue;
+
+        snprintf(e->dispositivo, sizeof(e->dispositivo), "%s", campos[0]);
+        snprintf(e->variante, sizeof(e->variante), "%s", campos[1]);
+        e->clase = atoi(campos[2]);
+        e->k_size = atoi(campos[3]);
+        e->local[0] = (size_t)atoi(campos[4]);
+        e->local[1] = (size_t)atoi(campos[5]);
+        e->ms = atof(campos[6]);
+        // {0, 0} = dejar que elija el runtime (local_work_size = NULL)
+        if ((e->local[0] > 0) == (e->local[1] > 0)) num_entradas++;
+    }
+    fclose(fp);
+}
+
+static EntradaAjuste* buscar_entrada(const char* dispositivo, const char* variante, int clase, int k_size) {
+    for (int i = 0; i < num_entradas; i++) {
+        EntradaAjuste* e = &entradas[i];
+        if (e->clase == clase && e->k_size == k_size &&
+            strcmp(e->variante, variante) == 0 && strcmp(e->dispositivo, dispositivo) == 0) {
+            return e;
+        }
+    }
+    return NULL;
+}
+
+int ajuste_clase(int width, int height) {
+    int lado = width > height ? width : height;
+    int clase = 64;
+    while (clase < lado) clase *= 2;
+    return clase;
+}
+
+int ajuste_buscar(cl_device_id device, const char* variante, int width, int height, int k_size,
+                  size_t local[2], double* ms) {
+    char dispositivo[128];
+    nombre_dispositivo(device, dispositivo, sizeof(dispositivo));
+
+    pthread_mutex_lock(&mutex_ajuste);
+    if (!cargado) cargar_archivo();
+    const EntradaAjuste* e = buscar_entrada(dispositivo, variante, ajuste_clase(width, height), k_size);
+    if (e) {
+        local[0] = e->local[0];
+        local[1] = e->local[1];
+        if (ms) *ms = e->ms;
+    }
+    pthread_mutex_unlock(&mutex_ajuste);
+    return e != NULL;
+}
+
+int ajuste_registrar(cl_device_id device, const char* variante, int width, int height, int k_size,
+                     const size_t local[2], double ms) {
+    char dispositivo[128];
+    nombre_dispositivo(device, dispositivo, sizeof(dispositivo));
+    int clase = ajuste_clase(width, height);
+    int ok = 0;
+
+    pthread_mutex_lock(&mutex_ajuste);
+    if (!cargado) cargar_archivo();
+
+    // 1. Actualizar la copia en memoria
+    EntradaAjuste* e = buscar_entrada(dispositivo, variante, clase, k_size);
+    if (!e) {
+        if (num_entradas == AJUSTE_MAX_ENTRADAS) goto cleanup;
+        e = &entradas[num_entradas++];
+        snprintf(e->dispositivo, sizeof(e->dispositivo), "%s", dispositivo);
+        snprintf(e->variante, sizeof(e->variante), "%s", variante);
+        e->clase = clase;
+        e->k_size = k_size;
+    }
+    e->local[0] = local[0];
+    e->local[1] = local[1];
+    e->ms = ms;
+
+    // 2. Reescribir el archivo completo en un temporal del proceso y reemplazarlo de
+    //    una vez, como la caché de binarios (si otro proceso ajusta a la vez gana el
+    //    último en escribir, pero el archivo siempre está completo)
+    char ruta[512], ruta_tmp[512 + 32];
+    ruta_ajuste(ruta, sizeof(ruta));
+    cache_ruta_temporal(ruta_tmp, sizeof(ruta_tmp), ruta);
+    crear_directorio(directorio_ajuste());  // Si ya existe falla sin consecuencias
+
+    FILE* fp = fopen(ruta_tmp, "w");
+    if (!fp) goto cleanup;
+    fprintf(fp, "# dispositivo\tvariante\tclase\tk\tlocal_x\tlocal_y\tms\n");
+    for (int i = 0; i < num_entradas; i++) {
+        const EntradaAjuste* a = &entradas[i];
+        fprintf(fp, "%s\t%s\t%d\t%d\t%zu\t%zu\t%.4f\n", a->dispositivo, a->variante, a->clase, a->k_size,
+                a->local[0], a->local[1], a->ms);
+    }
+    ok = (fclose(fp) == 0);
+    if (ok) {
+        ok = cache_reemplazar_archivo(ruta_tmp, ruta);
+    } else {
+        remove(ruta_tmp);
+    }
+
+cleanup:
+    pthread_mutex_unlock(&mutex_ajuste);
+    return ok;
+}
@@ -0,0 +1,6 @@
+#include "aleatorio.h"
+
+unsigned int aleatorio_siguiente(unsigned int* semilla) {
+    *semilla = *semilla * 1103515245u + 12345u;
+    return *semilla >> 16;
+}
@@ -0,0 +1,198 @@
+#include "cache_programas.h"
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef _WIN32
+#include <direct.h>
+#include <process.h>
+#include <windows.h>
+#define crear_directorio(ruta) _mkdir(ruta)
+#define id_proceso() _getpid()
+#else
+#include <sys/stat.h>
+#include <unistd.h>
+#define crear_directorio(ruta) mkdir(ruta, 0755)
+#define id_proceso() getpid()
+#endif
+
+// Cabecera de cada archivo: permite descartar archivos truncados o de otra versión
+#define CACHE_MAGIA "CLBIN001"
+
+typedef struct {
+    char magia[8];
+    uint64_t clave;
+    uint64_t tam_binario;
+} CabeceraCache;
+
+// ============================================
+// 1. Clave: FNV-1a de 64 bits sobre todo lo que invalida el binario
+// ============================================
+static uint64_t fnv1a(uint64_t h, const void* datos, size_t n) {
+    const unsigned char* p = (const unsigned char*)datos;
+    for (size_t i = 0; i < n; i++) {
+        h ^= p[i];
+        h *= 1099511628211ull;
+    }
+    // Separador: "ab"+"c" y "a"+"bc" dan claves distintas
+    h ^= 0xFF;
+    h *= 1099511628211ull;
+    return h;
+}
+
+static uint64_t fnv1a_info(uint64_t h, cl_int err, const char* texto) {
+    return fnv1a(h, err == CL_SUCCESS ? texto : "", err == CL_SUCCESS ? strlen(texto) : 0);
+}
+
+static uint64_t calcular_clave(cl_platform_id platform, cl_device_id device,
+                               const char* fuente, size_t tam_fuente, const char* opciones) {
+    char info[256];
+    uint64_t h = 14695981039346656037ull;
+
+    h = fnv1a(h, fuente, tam_fuente);
+    h = fnv1a(h, opciones, strlen(opciones));
+
+    cl_int err = clGetPlatformInfo(platform, CL_PLATFORM_NAME, sizeof(info), info, NULL);
+    h = fnv1a_info(h, err, info);
+    err = clGetDeviceInfo(device, CL_DEVICE_NAME, sizeof(info), info, NULL);
+    h = fnv1a_info(h, err, info);
+    err = clGetDeviceInfo(device, CL_DEVICE_VERSION, sizeof(info), info, NULL);
+    h = fnv1a_info(h, err, info);
+    err = clGetDeviceInfo(device, CL_DRIVER_VERSION, sizeof(info), info, NULL);
+    h = fnv1a_info(h, err, info);
+    return h;
+}
+
+static void ruta_cache(char* ruta, size_t tam, const char* dir, uint64_t clave) {
+    snprintf(ruta, tam, "%s/%016llx.bin", dir, (unsigned long long)clave);
+}
+
+// ============================================
+// 2. Lectura y escritura de binarios
+// ============================================
+// Devuelve el binario (malloc) si el archivo existe y su cabecera corresponde a 'clave'
+static unsigned char* leer_binario(const char* ruta, uint64_t clave, size_t* tam) {
+    FILE* fp = fopen(ruta, "rb");
+    if (!fp) return NULL;
+
+    CabeceraCache cab;
+    unsigned char* binario = NULL;
+    if (fread(&cab, sizeof(cab), 1, fp) == 1 &&
+        memcmp(cab.magia, CACHE_MAGIA, sizeof(cab.magia)) == 0 &&
+        cab.clave == clave && cab.tam_binario > 0) {
+        binario = (unsigned char*)malloc((size_t)cab.tam_binario);
+        if (binario && fread(binario, 1, (size_t)cab.tam_binario, fp) != cab.tam_binario) {
+            free(binario);
+            binario = NULL;
+        }
+    }
+    fclose(fp);
+
+    if (binario) *tam = (size_t)cab.tam_binario;
+    return binario;
+}
+
+void cache_ruta_temporal(char* ruta_tmp, size_t max, const char* ruta) {
+    snprintf(ruta_tmp, max, "%s.%ld.tmp", ruta, (long)id_proceso());
+}
+
+int cache_reemplazar_archivo(const char* ruta_tmp, const char* ruta) {
+#ifdef _WIN32
+    // rename() no reemplaza archivos existentes en Windows
+    int ok = MoveFileExA(ruta_tmp, ruta, MOVEFILE_REPLACE_EXISTING) != 0;
+#else
+    int ok = rename(ruta_tmp, ruta) == 0;
+#endif
+    if (!ok) remove(ruta_tmp);
+    return ok;
+}
+
+// Se escribe a un temporal propio del proceso y se reemplaza el archivo de una vez:
+// otro proceso nunca lee un archivo a medias ni se queda sin él
+static void guardar_binario(cl_program program, const char* dir, const char* ruta, uint64_t clave) {
+    cl_uint num_devices = 0;
+    clGetProgramInfo(program, CL_PROGRAM_NUM_DEVICES, sizeof(num_devices), &num_devices, NULL);
+    if (num_devices != 1) return;  // El programa se construye para un solo dispositivo
+
+    size_t tam = 0;
+    if (clGetProgramInfo(program, CL_PROGRAM_BINARY_SIZES, sizeof(tam), &tam, NULL) != CL_SUCCESS || tam == 0) return;
+
+    unsigned char* binario = (unsigned char*)malloc(tam);
+    if (!binario) return;
+    if (clGetProgramInfo(program, CL_PROGRAM_BINARIES, sizeof(binario), &binario, NULL) != CL_SUCCESS) {
+        free(binario);
+        return;
+    }
+
+    crear_directorio(dir);  // Si ya existe falla sin consecuencias
+
+    char ruta_tmp[512 + 32];
+    cache_ruta_temporal(ruta_tmp, sizeof(ruta_tmp), ruta);
+    FILE* fp = fopen(ruta_tmp, "wb");
+    if (fp) {
+        CabeceraCache cab;
+        memcpy(cab.magia, CACHE_MAGIA, sizeof(cab.magia));
+        cab.clave = clave;
+        cab.tam_binario = tam;
+        int ok = fwrite(&cab, sizeof(cab), 1, fp) == 1 && fwrite(binario, 1, tam, fp) == tam;
+        ok = (fclose(fp) == 0) && ok;
+
+        if (ok) {
+            cache_reemplazar_archivo(ruta_tmp, ruta);
+        } else {
+            remove(ruta_tmp);
+        }
+    }
+    free(binario);
+}
+
+// ============================================
+// 3. Construcción con caché
+// ============================================
+cl_program cache_programa_construir(cl_context context, cl_platform_id platform, cl_device_id device,
+                                    const char* fuente, size_t tam_fuente, const char* opciones,
+                                    int* desde_cache, cl_int* err) {
+    if (!opciones) opciones = "";
+    if (desde_cache) *desde_cache = 0;
+
+    const char* dir = getenv("CL_CACHE_DIR");
+    if (!dir || !dir[0]) dir = CACHE_PROGRAMAS_DIR;
+
+    uint64_t clave = calcular_clave(platform, device, fuente, tam_fuente, opciones);
+    char ruta[512];
+    ruta_cache(ruta, sizeof(ruta), dir, clave);
+
+    // 1. Binario cacheado: el build de un binario solo enlaza, no recompila
+    size_t tam_binario = 0;
+    unsigned char* binario = leer_binario(ruta, clave, &tam_binario);
+    if (binario) {
+        cl_int estado;
+        const unsigned char* binarios[1] = { binario };
+        cl_program program = clCreateProgramWithBinary(context, 1, &device, &tam_binario, binarios, &estado, err);
+        free(binario);
+
+        if (program && *err == CL_SUCCESS && estado == CL_SUCCESS) {
+            *err = clBuildProgram(program, 1, &device, opciones, NULL, NULL);
+            if (*err == CL_SUCCESS) {
+                if (desde_cache) *desde_cache = 1;
+                return program;
+            }
+        }
+        // Binario rechazado por el driver: se recompila y se sobrescribe
+        printf("Aviso: binario cacheado invalido (%s), compilando desde fuente.\n", ruta);
+        if (program) clReleaseProgram(program);
+    }
+
+    // 2. Build desde la fuente
+    cl_program program = clCreateProgramWithSource(context, 1, &fuente, &tam_fuente, err);
+    if (!program || *err != CL_SUCCESS) {
+        if (program) clReleaseProgram(program);
+        return NULL;
+    }
+
+    *err = clBuildProgram(program, 1, &device, opciones, NULL, NULL);
+    if (*err == CL_SUCCESS) guardar_binario(program, dir, ruta, clave);
+    return program;
+}
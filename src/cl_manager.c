@@ -1,4 +1,7 @@
 #include "cl_manager.h"
+#include "cache_programas.h"
+#include "plataforma.h"
+#include "reloj.h"
 #include <stdlib.h>
 #include <string.h>
 
@@ -31,6 +34,8 @@ int CLManager_Init(CLManager* mgr) {
     cl_int err;
     cl_uint num_platforms;
 
+    memset(mgr, 0, sizeof(*mgr));
+
     // 1. Detectar Plataformas
     err = clGetPlatformIDs(0, NULL, &num_platforms);
     if (err != CL_SUCCESS || num_platforms == 0) {
@@ -91,6 +96,12 @@ int CLManager_Init(CLManager* mgr) {
     printf("  Device:   %s\n", name);
     printf("  Compute Units: %u\n", units);
 
+    // Memoria unificada: CLManager_AllocHost puede dar memoria zero-copy
+    cl_bool unificada = CL_FALSE;
+    clGetDeviceInfo(mgr->device_id, CL_DEVICE_HOST_UNIFIED_MEMORY, sizeof(unificada), &unificada, NULL);
+    mgr->memoria_unificada = (unificada == CL_TRUE);
+    printf("  Memoria unificada: %s\n", mgr->memoria_unificada ? "si (zero-copy)" : "no (pinned)");
+
     // 4. Contexto y Cola
     mgr->context = clCreateContext(NULL, 1, &mgr->device_id, NULL, NULL, &err);
 
@@ -114,10 +125,23 @@ int CLManager_LoadKernel(CLManager* mgr, const char* filename, const char* kerne
 
     printf("Archivo: %s (%zu bytes)\n", filename, src_size);
 
-    mgr->program = clCreateProgramWithSource(mgr->context, 1, (const char**)&source_str, &src_size, &err);
-    free(source_str);
+    // Binario cacheado en disco si corresponde a esta fuente/dispositivo/driver,
+    // si no build desde la fuente (y se guarda el binario para la próxima vez)
+    int desde_cache;
+    double inicio = reloj_ms();
+    mgr->program = cache_programa_construir(mgr->context, mgr->platform_id, mgr->device_id,
+                                            source_str, src_size, NULL, &desde_cache, &err);
+    double build_ms = reloj_ms() - inicio;
+
+    // La fuente se conserva para compilar variantes especializadas bajo demanda
+    free(mgr->fuente);
+    mgr->fuente = source_str;
+    mgr->tam_fuente = src_size;
 
-    err = clBuildProgram(mgr->program, 1, &mgr->device_id, NULL, NULL, NULL);
+    if (!mgr->program) {
+        printf("Error creando el programa OpenCL (Code %d)\n", err);
+        return 0;
+    }
 
     if (err != CL_SUCCESS) {
         // Log de error
@@ -127,13 +151,254 @@ int CLManager_LoadKernel(CLManager* mgr, const char* filename, const char* kerne
         return 0;
     }
 
-    printf("✓ Kernel compilado exitosamente.\n");
+    if (desde_cache) printf("✓ Kernel cargado desde la cache de binarios (%.1f ms).\n", build_ms);
+    else printf("✓ Kernel compilado exitosamente (%.1f ms).\n", build_ms);
 
     mgr->kernel = clCreateKernel(mgr->program, kernel_name, &err);
     return (err == CL_SUCCESS);
 }
 
+// Busca 'nombre' entre los kernels ya creados de 'program' o lo crea y lo añade
+// (si queda hueco en los 'max' de la caché)
+static cl_kernel kernel_cacheado(cl_program program, cl_kernel* kernels, char (*nombres)[64], int* num, int max,
+                                 const char* nombre) {
+    for (int i = 0; i < *num; i++) {
+        if (strcmp(nombres[i], nombre) == 0) return kernels[i];
+    }
+
+    if (!program || *num >= max) return NULL;
+
+    cl_int err;
+    cl_kernel kernel = clCreateKernel(program, nombre, &err);
+    if (err != CL_SUCCESS) {
+        printf("Error: No se pudo crear el kernel '%s' (Code %d)\n", nombre, err);
+        return NULL;
+    }
+
+    int i = (*num)++;
+    kernels[i] = kernel;
+    snprintf(nombres[i], 64, "%s", nombre);
+    return kernel;
+}
+
+cl_kernel CLManager_GetKernel(CLManager* mgr, const char* nombre) {
+    return kernel_cacheado(mgr->program, mgr->kernels, mgr->nombres_kernels, &mgr->num_kernels,
+                           CL_MANAGER_MAX_KERNELS, nombre);
+}
+
+static void variante_liberar(CLVariante* v) {
+    for (int i = 0; i < v->num_kernels; i++) clReleaseKernel(v->kernels[i]);
+    if (v->program) clReleaseProgram(v->program);
+    free(v->opciones);
+    memset(v, 0, sizeof(*v));
+}
+
+cl_kernel CLManager_GetKernelVariante(CLManager* mgr, const char* nombre, const char* opciones) {
+    if (!mgr->fuente) return NULL;
+
+    // 1. Variante ya compilada con estas opciones
+    CLVariante* v = NULL;
+    for (int i = 0; i < mgr->num_variantes && !v; i++) {
+        if (strcmp(mgr->variantes[i].opciones, opciones) == 0) v = &mgr->variantes[i];
+    }
+
+    // 2. Si no, compilarla en un hueco libre o en el de la variante usada hace más tiempo
+    if (!v) {
+        if (mgr->num_variantes < CL_MANAGER_MAX_VARIANTES) {
+            v = &mgr->variantes[mgr->num_variantes++];
+        } else {
+            v = &mgr->variantes[0];
+            for (int i = 1; i < mgr->num_variantes; i++) {
+                if (mgr->variantes[i].ultimo_uso < v->ultimo_uso) v = &mgr->variantes[i];
+            }
+            variante_liberar(v);
+        }
+
+        size_t tam_opciones = strlen(opciones) + 1;
+        v->opciones = (char*)malloc(tam_opciones);
+        if (!v->opciones) {
+            *v = mgr->variantes[--mgr->num_variantes];
+            return NULL;
+        }
+        memcpy(v->opciones, opciones, tam_opciones);
+
+        cl_int err;
+        int desde_cache;
+        double inicio = reloj_ms();
+        v->program = cache_programa_construir(mgr->context, mgr->platform_id, mgr->device_id,
+                                              mgr->fuente, mgr->tam_fuente, opciones, &desde_cache, &err);
+        if (v->program && err != CL_SUCCESS) {
+            char log[4096];
+            clGetProgramBuildInfo(v->program, mgr->device_id, CL_PROGRAM_BUILD_LOG, sizeof(log), log, NULL);
+            printf("Aviso: no se pudo compilar la variante (%.48s): se usa el kernel generico.\n%s\n", opciones, log);
+            clReleaseProgram(v->program);
+            v->program = NULL;
+        } else if (v->program) {
+            printf("[Info] Variante (%.48s) %s en %.1f ms\n", opciones,
+                   desde_cache ? "cargada desde la cache" : "compilada", reloj_ms() - inicio);
+        }
+    }
+
+    v->ultimo_uso = ++mgr->usos_variantes;
+    return kernel_cacheado(v->program, v->kernels, v->nombres_kernels, &v->num_kernels,
+                           CL_MANAGER_MAX_KERNELS_VARIANTE, nombre);
+}
+
+// Quita la entrada i del pool (el hueco lo ocupa la última)
+static void pool_quitar(CLManager* mgr, int i) {
+    clReleaseMemObject(mgr->buffers[i].buffer);
+    mgr->pool_bytes -= mgr->buffers[i].bytes;
+    mgr->buffers[i] = mgr->buffers[--mgr->num_buffers];
+}
+
+cl_mem CLManager_AcquireBuffer(CLManager* mgr, cl_mem_flags flags, size_t bytes, cl_int* err) {
+    int mejor = -1, reemplazo = -1;
+    *err = CL_SUCCESS;
+    if (bytes == 0) bytes = 1;
+
+    // 1. Buffer libre más pequeño que sirva (o, si no hay, uno libre a reemplazar)
+    for (int i = 0; i < mgr->num_buffers; i++) {
+        CLBufferPool* b = &mgr->buffers[i];
+        if (b->en_uso || b->flags != flags) continue;
+        if (b->bytes >= bytes) {
+            if (mejor < 0 || b->bytes < mgr->buffers[mejor].bytes) mejor = i;
+        } else if (reemplazo < 0 || b->bytes > mgr->buffers[reemplazo].bytes) {
+            reemplazo = i;
+        }
+    }
+
+    if (mejor >= 0) {
+        mgr->pool_aciertos++;
+        mgr->buffers[mejor].en_uso = 1;
+        return mgr->buffers[mejor].buffer;
+    }
+
+    // 2. Fallo: crecer reemplazando un libre más pequeño, o ocupar una entrada nueva
+    mgr->pool_fallos++;
+    if (reemplazo >= 0) pool_quitar(mgr, reemplazo);
+
+    cl_mem buffer = clCreateBuffer(mgr->context, flags, bytes, NULL, err);
+    if (*err != CL_SUCCESS) return NULL;
+
+    if (mgr->num_buffers < CL_MANAGER_MAX_BUFFERS) {
+        CLBufferPool* b = &mgr->buffers[mgr->num_buffers++];
+        b->buffer = buffer;
+        b->bytes = bytes;
+        b->flags = flags;
+        b->en_uso = 1;
+        mgr->pool_bytes += bytes;
+    }
+    // Pool lleno: el buffer funciona igual, pero ReleaseBuffer lo liberará de verdad
+    return buffer;
+}
+
+void CLManager_ReleaseBuffer(CLManager* mgr, cl_mem buffer) {
+    if (!buffer) return;
+    for (int i = 0; i < mgr->num_buffers; i++) {
+        if (mgr->buffers[i].buffer == buffer) {
+            mgr->buffers[i].en_uso = 0;
+            return;
+        }
+    }
+    clReleaseMemObject(buffer);
+}
+
+void CLManager_TrimBuffers(CLManager* mgr, size_t bytes_max) {
+    while (mgr->pool_bytes > bytes_max) {
+        int mayor = -1;
+        for (int i = 0; i < mgr->num_buffers; i++) {
+            if (mgr->buffers[i].en_uso) continue;
+            if (mayor < 0 || mgr->buffers[i].bytes > mgr->buffers[mayor].bytes) mayor = i;
+        }
+        if (mayor < 0) break;  // Solo quedan buffers en uso
+        pool_quitar(mgr, mayor);
+    }
+}
+
+void CLManager_PrintPoolStats(const CLManager* mgr) {
+    printf("[Info] Pool de buffers: %lu aciertos, %lu fallos, %d buffers, %.2f MB retenidos\n",
+           mgr->pool_aciertos, mgr->pool_fallos, mgr->num_buffers, mgr->pool_bytes / (1024.0 * 1024.0));
+}
+
+unsigned char* CLManager_AllocHost(CLManager* mgr, size_t bytes) {
+    cl_int err = CL_MEM_OBJECT_ALLOCATION_FAILURE;
+    size_t reservados = (bytes + CL_MANAGER_GRANO_HOST - 1) / CL_MANAGER_GRANO_HOST * CL_MANAGER_GRANO_HOST;
+    if (reservados == 0) reservados = CL_MANAGER_GRANO_HOST;
+
+    if (mgr->num_host < CL_MANAGER_MAX_HOST) {
+        CLMemoriaHost* h = &mgr->host[mgr->num_host];
+        memset(h, 0, sizeof(*h));
+        h->bytes = reservados;
+
+        if (mgr->memoria_unificada) {
+            // 1. Zero-copy: el buffer es la memoria del host
+            h->ptr = (unsigned char*)reservar_alineado(reservados, CL_MANAGER_ALINEACION_HOST);
+            if (h->ptr) {
+                h->buffer = clCreateBuffer(mgr->context, CL_MEM_READ_WRITE | CL_MEM_USE_HOST_PTR, reservados, h->ptr, &err);
+                if (err == CL_SUCCESS) {
+                    h->zero_copy = 1;
+                    mgr->num_host++;
+                    return h->ptr;
+                }
+                liberar_alineado(h->ptr);
+            }
+        } else {
+            // 2. Pinned: el driver reserva memoria de host bloqueada y la mapeamos una vez
+            h->buffer = clCreateBuffer(mgr->context, CL_MEM_READ_WRITE | CL_MEM_ALLOC_HOST_PTR, reservados, NULL, &err);
+            if (err == CL_SUCCESS) {
+                h->ptr = (unsigned char*)clEnqueueMapBuffer(mgr->queue, h->buffer, CL_TRUE, CL_MAP_READ | CL_MAP_WRITE,
+                                                            0, reservados, 0, NULL, NULL, &err);
+                if (err == CL_SUCCESS) {
+                    mgr->num_host++;
+                    return h->ptr;
+                }
+                clReleaseMemObject(h->buffer);
+            }
+        }
+        printf("Aviso: no se pudo reservar memoria de host para OpenCL (Code %d), usando malloc.\n", err);
+    }
+
+    // 3. Sin buffer: memoria normal (las copias pasan por un buffer intermedio del driver)
+    return (unsigned char*)malloc(bytes);
+}
+
+void CLManager_FreeHost(CLManager* mgr, void* ptr) {
+    if (!ptr) return;
+    for (int i = 0; i < mgr->num_host; i++) {
+        CLMemoriaHost* h = &mgr->host[i];
+        if (h->ptr != ptr) continue;
+
+        if (h->zero_copy) {
+            clReleaseMemObject(h->buffer);
+            clFinish(mgr->queue);
+            liberar_alineado(h->ptr);
+        } else {
+            clEnqueueUnmapMemObject(mgr->queue, h->buffer, h->ptr, 0, NULL, NULL);
+            clFinish(mgr->queue);
+            clReleaseMemObject(h->buffer);
+        }
+        mgr->host[i] = mgr->host[--mgr->num_host];
+        return;
+    }
+    free(ptr);
+}
+
+cl_mem CLManager_HostBuffer(CLManager* mgr, const void* ptr, size_t bytes) {
+    for (int i = 0; i < mgr->num_host; i++) {
+        const CLMemoriaHost* h = &mgr->host[i];
+        if (h->zero_copy && h->ptr == ptr && bytes <= h->bytes) return h->buffer;
+    }
+    return NULL;
+}
+
 void CLManager_Cleanup(CLManager* mgr) {
+    while (mgr->num_host > 0) CLManager_FreeHost(mgr, mgr->host[mgr->num_host - 1].ptr);
+    while (mgr->num_buffers > 0) pool_quitar(mgr, mgr->num_buffers - 1);
+    for (int i = 0; i < mgr->num_kernels; i++) clReleaseKernel(mgr->kernels[i]);
+    mgr->num_kernels = 0;
+    while (mgr->num_variantes > 0) variante_liberar(&mgr->variantes[--mgr->num_variantes]);
+    free(mgr->fuente);
+    mgr->fuente = NULL;
     if(mgr->kernel) clReleaseKernel(mgr->kernel);
     if(mgr->program) clReleaseProgram(mgr->program);
     if(mgr->queue) clReleaseCommandQueue(mgr->queue);
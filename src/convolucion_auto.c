@@ -0,0 +1,30 @@
+#include "convolucion_auto.h"
+#include "convolucion_caja.h"
+#include "convolucion_fft.h"
+#include "convolucion_hilos.h"
+#include "convolucion_separable.h"
+#include "filtro.h"
+
+void convolucion_auto(const unsigned char* input, unsigned char* output,
+                      int width, int height, const float* kernel, int k_size) {
+    PlanoImagen entrada = { (unsigned char*)input, width, height, (size_t)width };
+    PlanoImagen salida = { output, width, height, (size_t)width };
+    convolucion_auto_plano(&entrada, &salida, kernel, k_size);
+}
+
+void convolucion_auto_plano(const PlanoImagen* entrada, const PlanoImagen* salida,
+                            const float* kernel, int k_size) {
+    FiltroInfo filtro;
+    filtro_analizar(kernel, k_size, &filtro);
+
+    if (filtro_usar_caja(&filtro)) {
+        convolucion_caja_plano(entrada, salida, k_size, filtro.peso_uniforme);
+    } else if (filtro_usar_separable(&filtro)) {
+        convolucion_separable_plano(entrada, salida, &filtro);
+    } else if (k_size >= FILTRO_K_MIN_FFT &&
+               fft_conviene(fft_calibracion_cpu(), entrada->width, entrada->height, k_size)) {
+        convolucion_fft_plano(entrada, salida, kernel, k_size);
+    } else {
+        convolucion_hilos_plano(entrada, salida, kernel, k_size);
+    }
+}
@@ -0,0 +1,150 @@
+#include "convolucion_caja.h"
+#include "pool_hilos.h"
+#include "progreso.h"
+
+#include <stdatomic.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+// Filas mínimas por banda: cada banda paga O(k_size) filas para arrancar sus sumas
+#define FILAS_MIN_BANDA 64
+
+typedef struct {
+    const unsigned char* input;
+    unsigned char* output;
+    size_t pitch_entrada;       // Bytes entre filas de input / output
+    size_t pitch_salida;
+    int width;
+    int height;
+    int k_size;
+    float peso;
+    int filas_por_banda;
+    atomic_int error;           // Alguna banda no consiguió memoria (sus filas quedan sin escribir)
+    Progreso progreso;
+} TrabajoCaja;
+
+static int clamp_int(int v, int lo, int hi) {
+    return v < lo ? lo : (v > hi ? hi : v);
+}
+
+static unsigned char saturar(float v) {
+    v = v < 0.0f ? 0.0f : v;
+    v = v > 255.0f ? 255.0f : v;
+    return (unsigned char)v;
+}
+
+// Una fila de salida: ventana horizontal deslizante sobre las sumas de columna
+static void fila_caja(const uint32_t* columnas, unsigned char* dst, int width, int k_size, float peso) {
+    int half = k_size / 2;
+
+    // 1. Ventana inicial centrada en x = 0 (los vecinos a la izquierda repiten la columna 0)
+    uint32_t suma = 0;
+    for (int j = -half; j <= half; j++) suma += columnas[clamp_int(j, 0, width - 1)];
+    dst[0] = saturar((float)suma * peso);
+
+    // 2. Deslizar: entra x + half, sale x - half - 1. En el tramo central
+    //    ninguno de los dos índices necesita clamp.
+    int x_ini = half + 1 < width ? half + 1 : width;
+    int x_fin = width - half > x_ini ? width - half : x_ini;
+    int x = 1;
+    for (; x < x_ini; x++) {
+        suma += columnas[clamp_int(x + half, 0, width - 1)];
+        suma -= columnas[clamp_int(x - half - 1, 0, width - 1)];
+        dst[x] = saturar((float)suma * peso);
+    }
+    for (; x < x_fin; x++) {
+        suma += columnas[x + half] - columnas[x - half - 1];
+        dst[x] = saturar((float)suma * peso);
+    }
+    for (; x < width; x++) {
+        suma += columnas[width - 1];
+        suma -= columnas[x - half - 1];
+        dst[x] = saturar((float)suma * peso);
+    }
+}
+
+static void procesar_banda(void* contexto, int banda) {
+    TrabajoCaja* t = (TrabajoCaja*)contexto;
+    int width = t->width;
+    int height = t->height;
+    int half = t->k_size / 2;
+
+    int y_ini = banda * t->filas_por_banda;
+    int y_fin = y_ini + t->filas_por_banda < height ? y_ini + t->filas_por_banda : height;
+
+    uint32_t* columnas = (uint32_t*)malloc(sizeof(uint32_t) * width);
+    if (!columnas) {
+        atomic_store(&t->error, 1);
+        return;
+    }
+
+    // 1. Suma vertical de la ventana de la primera fila de la banda
+    for (int x = 0; x < width; x++) columnas[x] = 0;
+    for (int i = -half; i <= half; i++) {
+        const unsigned char* src = t->input + (size_t)clamp_int(y_ini + i, 0, height - 1) * t->pitch_entrada;
+        for (int x = 0; x < width; x++) columnas[x] += src[x];
+    }
+
+    for (int y = y_ini; y < y_fin; y++) {
+        fila_caja(columnas, t->output + (size_t)y * t->pitch_salida, width, t->k_size, t->peso);
+
+        // 2. Deslizar la ventana vertical a la fila siguiente (se autovectoriza)
+        if (y + 1 < y_fin) {
+            const unsigned char* entra = t->input + (size_t)clamp_int(y + half + 1, 0, height - 1) * t->pitch_entrada;
+            const unsigned char* sale = t->input + (size_t)clamp_int(y - half, 0, height - 1) * t->pitch_entrada;
+            for (int x = 0; x < width; x++) columnas[x] += (uint32_t)entra[x] - sale[x];
+        }
+    }
+
+    free(columnas);
+    progreso_avanzar(&t->progreso, y_fin - y_ini);
+}
+
+void convolucion_caja(const unsigned char* input, unsigned char* output,
+                      int width, int height, int k_size, float peso) {
+    PlanoImagen entrada = { (unsigned char*)input, width, height, (size_t)width };
+    PlanoImagen salida = { output, width, height, (size_t)width };
+    convolucion_caja_plano(&entrada, &salida, k_size, peso);
+}
+
+void convolucion_caja_plano(const PlanoImagen* entrada, const PlanoImagen* salida, int k_size, float peso) {
+    int height = entrada->height;
+
+    // Sin pool de hilos las bandas se procesan en este hilo (mismo resultado)
+    PoolHilos* pool = pool_global();
+    int num_hilos = pool ? pool_num_hilos(pool) : 1;
+
+    // Bandas de al menos 2 * k_size filas para amortizar el arranque de cada una
+    int filas_por_banda = (height + num_hilos * 4 - 1) / (num_hilos * 4);
+    if (filas_por_banda < FILAS_MIN_BANDA) filas_por_banda = FILAS_MIN_BANDA;
+    if (filas_por_banda < 2 * k_size) filas_por_banda = 2 * k_size;
+
+    TrabajoCaja trabajo = {
+        .input = entrada->datos,
+        .output = salida->datos,
+        .pitch_entrada = entrada->pitch,
+        .pitch_salida = salida->pitch,
+        .width = entrada->width,
+        .height = height,
+        .k_size = k_size,
+        .peso = peso,
+        .filas_por_banda = filas_por_banda,
+    };
+    atomic_init(&trabajo.error, 0);
+    progreso_iniciar(&trabajo.progreso, height);
+
+    int num_bandas = (height + filas_por_banda - 1) / filas_por_banda;
+    if (pool) {
+        pool_ejecutar(pool, num_bandas, procesar_banda, &trabajo);
+    } else {
+        for (int banda = 0; banda < num_bandas; banda++) procesar_banda(&trabajo, banda);
+    }
+
+    progreso_finalizar(&trabajo.progreso);
+    if (atomic_load(&trabajo.error)) {
+        printf("Error: Fallo de memoria en el filtro de caja (salida incompleta).\n");
+        return;
+    }
+    printf("[Info] Filtro de caja %dx%d: sumas deslizantes, O(1) por pixel\n", k_size, k_size);
+}
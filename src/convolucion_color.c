@@ -0,0 +1,162 @@
+#include "convolucion_color.h"
+#include "pool_hilos.h"
+#include "progreso.h"
+
+#include <stdio.h>
+
+// Bytes de fila por bloque del interior: el acumulador (4 KB) vive en L1
+#define BLOQUE_BYTES 1024
+// Igual que en convolucion_hilos: bandas pequeñas para repartir bien
+#define FILAS_POR_BANDA_MAX 16
+#define BANDAS_POR_HILO 8
+
+typedef struct {
+    const unsigned char* input;
+    unsigned char* output;
+    int width;
+    int height;
+    int canales;
+    const float* kernel;
+    int k_size;
+    int copiar_alpha;       // 1 = el último canal se copia de la entrada
+    int filas_banda;
+    Progreso progreso;
+} TrabajoColor;
+
+static unsigned char saturar(float sum) {
+    sum = sum < 0.0f ? 0.0f : sum;
+    sum = sum > 255.0f ? 255.0f : sum;
+    return (unsigned char)sum;
+}
+
+// Un píxel (todos sus canales) con clamp-to-edge, mismo orden que convolucion_pixel()
+static void pixel_color(const TrabajoColor* t, int x, int y) {
+    int half = t->k_size / 2;
+    int c_n = t->canales;
+    float sum[4] = { 0.0f, 0.0f, 0.0f, 0.0f };
+
+    for (int ky = -half; ky <= half; ky++) {
+        int iy = y + ky;
+        if (iy < 0) iy = 0;
+        if (iy >= t->height) iy = t->height - 1;
+
+        for (int kx = -half; kx <= half; kx++) {
+            int ix = x + kx;
+            if (ix < 0) ix = 0;
+            if (ix >= t->width) ix = t->width - 1;
+
+            const unsigned char* p = t->input + ((size_t)iy * t->width + ix) * c_n;
+            float weight = t->kernel[(ky + half) * t->k_size + (kx + half)];
+            for (int c = 0; c < c_n; c++) sum[c] += (float)p[c] * weight;
+        }
+    }
+
+    unsigned char* out = t->output + ((size_t)y * t->width + x) * c_n;
+    for (int c = 0; c < c_n; c++) out[c] = saturar(sum[c]);
+}
+
+// Interior de la fila y, píxeles [x_ini, x_fin): el byte j de la salida suma los
+// bytes j + (kx - half) * canales de cada fila de la ventana, sin importar el canal
+static void interior_color(const TrabajoColor* t, int y, int x_ini, int x_fin) {
+    int half = t->k_size / 2;
+    int c_n = t->canales;
+    size_t paso_fila = (size_t)t->width * c_n;
+    float acc[BLOQUE_BYTES];
+
+    int j_ini = x_ini * c_n, j_fin = x_fin * c_n;
+    for (int j0 = j_ini; j0 < j_fin; j0 += BLOQUE_BYTES) {
+        int n = j_fin - j0 < BLOQUE_BYTES ? j_fin - j0 : BLOQUE_BYTES;
+
+        for (int i = 0; i < n; i++) acc[i] = 0.0f;
+
+        for (int ky = 0; ky < t->k_size; ky++) {
+            const unsigned char* fila = t->input + (size_t)(y - half + ky) * paso_fila + j0 - half * c_n;
+            const float* pesos = t->kernel + ky * t->k_size;
+
+            for (int kx = 0; kx < t->k_size; kx++) {
+                const unsigned char* p = fila + kx * c_n;
+                float weight = pesos[kx];
+                for (int i = 0; i < n; i++) {
+                    acc[i] += (float)p[i] * weight;
+                }
+            }
+        }
+
+        unsigned char* out = t->output + (size_t)y * paso_fila + j0;
+        for (int i = 0; i < n; i++) out[i] = saturar(acc[i]);
+    }
+}
+
+static void procesar_filas(const TrabajoColor* t, int y_ini, int y_fin) {
+    int half = t->k_size / 2;
+    int x_ini = half, x_fin = t->width - half;
+
+    for (int y = y_ini; y < y_fin; y++) {
+        if (y < half || y >= t->height - half || x_ini >= x_fin) {
+            for (int x = 0; x < t->width; x++) pixel_color(t, x, y);
+        } else {
+            for (int x = 0; x < x_ini; x++) pixel_color(t, x, y);
+            interior_color(t, y, x_ini, x_fin);
+            for (int x = x_fin; x < t->width; x++) pixel_color(t, x, y);
+        }
+
+        // Alfa sin filtrar: se restaura desde la entrada
+        if (t->copiar_alpha) {
+            size_t base = (size_t)y * t->width * t->canales + (t->canales - 1);
+            for (int x = 0; x < t->width; x++) {
+                size_t i = base + (size_t)x * t->canales;
+                t->output[i] = t->input[i];
+            }
+        }
+    }
+}
+
+static void procesar_banda(void* contexto, int banda) {
+    TrabajoColor* t = (TrabajoColor*)contexto;
+
+    int y_ini = banda * t->filas_banda;
+    int y_fin = y_ini + t->filas_banda;
+    if (y_fin > t->height) y_fin = t->height;
+
+    procesar_filas(t, y_ini, y_fin);
+    progreso_avanzar(&t->progreso, y_fin - y_ini);
+}
+
+void convolucion_color(const unsigned char* input, unsigned char* output,
+                       int width, int height, int canales, const float* kernel, int k_size, int filtrar_alpha) {
+    if (canales < 1 || canales > 4) {
+        printf("Error: convolucion_color admite de 1 a 4 canales (recibio %d)\n", canales);
+        return;
+    }
+
+    TrabajoColor trabajo = {
+        .input = input,
+        .output = output,
+        .width = width,
+        .height = height,
+        .canales = canales,
+        .kernel = kernel,
+        .k_size = k_size,
+        .copiar_alpha = !filtrar_alpha && (canales == 2 || canales == 4),
+    };
+    progreso_iniciar(&trabajo.progreso, height);
+
+    PoolHilos* pool = pool_global();
+    if (!pool) {
+        procesar_filas(&trabajo, 0, height);
+        progreso_finalizar(&trabajo.progreso);
+        return;
+    }
+
+    int filas_banda = height / (pool_num_hilos(pool) * BANDAS_POR_HILO);
+    if (filas_banda < 1) filas_banda = 1;
+    if (filas_banda > FILAS_POR_BANDA_MAX) filas_banda = FILAS_POR_BANDA_MAX;
+    trabajo.filas_banda = filas_banda;
+
+    int num_bandas = (height + filas_banda - 1) / filas_banda;
+    pool_ejecutar(pool, num_bandas, procesar_banda, &trabajo);
+
+    progreso_finalizar(&trabajo.progreso);
+    printf("[Info] Color: %d canales%s, %d bandas de %d filas\n", canales,
+           trabajo.copiar_alpha ? " (alfa sin filtrar)" : "", num_bandas, filas_banda);
+}
@@ -0,0 +1,409 @@
+#include "convolucion_fft.h"
+#include "aleatorio.h"
+#include "convolucion_simd.h"
+#include "fft.h"
+#include "filtro.h"
+#include "pool_hilos.h"
+#include "reloj.h"
+
+#include <math.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Pares de filas por tarea en las pasadas horizontales
+#define PARES_POR_TAREA 4
+// Columnas que se copian juntas en las pasadas verticales (acceso contiguo por fila)
+#define COLUMNAS_POR_BLOQUE 16
+// Imagen y filtro sintéticos de la calibración
+#define CALIBRACION_LADO 256
+#define CALIBRACION_K 21
+#define CALIBRACION_REPETICIONES 3
+
+typedef enum {
+    FASE_FILAS_IMAGEN,
+    FASE_FILAS_FILTRO,
+    FASE_COLUMNAS_IMAGEN,
+    FASE_COLUMNAS_FILTRO,
+    FASE_PRODUCTO,
+    FASE_COLUMNAS_INVERSA,
+    FASE_FILAS_INVERSA
+} FaseFFT;
+
+typedef struct {
+    const unsigned char* input;
+    unsigned char* output;
+    size_t pitch_entrada;       // Bytes entre filas de input / output
+    size_t pitch_salida;
+    int width;
+    int height;
+    const float* kernel;
+    int k_size;
+    int half;
+
+    int nx, ny;                 // Tamaño de la transformada
+    int mx;                     // Columnas del espectro: nx / 2 + 1
+    PlanFFT plan_x, plan_y;
+    Complejo* espectro_imagen;  // ny * mx
+    Complejo* espectro_filtro;  // ny * mx
+
+    FaseFFT fase;
+    atomic_int error;           // Alguna tarea no consiguió memoria
+} TrabajoFFT;
+
+static int clamp_int(int v, int lo, int hi) {
+    return v < lo ? lo : (v > hi ? hi : v);
+}
+
+static unsigned char saturar(float v) {
+    v = v < 0.0f ? 0.0f : v;
+    v = v > 255.0f ? 255.0f : v;
+    return (unsigned char)v;
+}
+
+// ============================================
+// 1. Generación de filas reales
+// ============================================
+// Fila r de la imagen extendida: borde replicado en [0, width + 2*half), ceros después.
+// Devuelve 0 si la fila es toda ceros.
+static int fila_imagen(const TrabajoFFT* t, int r, float* dst) {
+    if (r >= t->height + 2 * t->half) return 0;
+
+    const unsigned char* src = t->input + (size_t)clamp_int(r - t->half, 0, t->height - 1) * t->pitch_entrada;
+    int extendido = t->width + 2 * t->half;
+    for (int x = 0; x < extendido; x++) dst[x] = (float)src[clamp_int(x - t->half, 0, t->width - 1)];
+    for (int x = extendido; x < t->nx; x++) dst[x] = 0.0f;
+    return 1;
+}
+
+// Fila r del filtro volteado y centrado en el origen (con vuelta circular):
+// G[(half - i) mod ny][(half - j) mod nx] = K[i][j], así la convolución circular
+// con G calcula la misma correlación que convolucion_secuencial().
+static int fila_filtro(const TrabajoFFT* t, int r, float* dst) {
+    int i = ((t->half - r) % t->ny + t->ny) % t->ny;
+    if (i >= t->k_size) return 0;
+
+    for (int x = 0; x < t->nx; x++) dst[x] = 0.0f;
+    for (int j = 0; j < t->k_size; j++) {
+        int x = ((t->half - j) % t->nx + t->nx) % t->nx;
+        dst[x] = t->kernel[i * t->k_size + j];
+    }
+    return 1;
+}
+
+// ============================================
+// 2. Pasadas
+// ============================================
+// Filas r0 y r0 + 1 a la vez: z = a + i*b, Z = FFT(z) y se separan los espectros
+// A[k] = (Z[k] + conj(Z[n-k])) / 2,  B[k] = (Z[k] - conj(Z[n-k])) / 2i
+static void filas_directas(TrabajoFFT* t, int tarea, int es_filtro) {
+    int nx = t->nx, mx = t->mx;
+    Complejo* espectro = es_filtro ? t->espectro_filtro : t->espectro_imagen;
+
+    float* a = (float*)malloc(sizeof(float) * nx * 2);
+    Complejo* z = (Complejo*)malloc(sizeof(Complejo) * nx * 2);
+    if (!a || !z) {
+        atomic_store(&t->error, 1);
+        free(a);
+        free(z);
+        return;
+    }
+    float* b = a + nx;
+    Complejo* temp = z + nx;
+
+    int num_pares = (t->ny + 1) / 2;
+    int p_fin = (tarea + 1) * PARES_POR_TAREA < num_pares ? (tarea + 1) * PARES_POR_TAREA : num_pares;
+
+    for (int p = tarea * PARES_POR_TAREA; p < p_fin; p++) {
+        int r0 = 2 * p, r1 = 2 * p + 1;
+        int hay_a = es_filtro ? fila_filtro(t, r0, a) : fila_imagen(t, r0, a);
+        int hay_b = r1 < t->ny && (es_filtro ? fila_filtro(t, r1, b) : fila_imagen(t, r1, b));
+        Complejo* fila0 = espectro + (size_t)r0 * mx;
+        Complejo* fila1 = espectro + (size_t)r1 * mx;
+
+        // Filas a cero (relleno, o fuera del soporte del filtro): espectro nulo
+        if (!hay_a && !hay_b) {
+            memset(fila0, 0, sizeof(Complejo) * mx);
+            if (r1 < t->ny) memset(fila1, 0, sizeof(Complejo) * mx);
+            continue;
+        }
+
+        for (int x = 0; x < nx; x++) {
+            z[x].re = hay_a ? a[x] : 0.0f;
+            z[x].im = hay_b ? b[x] : 0.0f;
+        }
+        fft_ejecutar(&t->plan_x, z, temp, 0);
+
+        for (int k = 0; k < mx; k++) {
+            Complejo zk = z[k];
+            Complejo zn = z[(nx - k) % nx];
+            fila0[k].re = 0.5f * (zk.re + zn.re);
+            fila0[k].im = 0.5f * (zk.im - zn.im);
+            if (r1 < t->ny) {
+                fila1[k].re = 0.5f * (zk.im + zn.im);
+                fila1[k].im = -0.5f * (zk.re - zn.re);
+            }
+        }
+    }
+
+    free(a);
+    free(z);
+}
+
+// Bloque de COLUMNAS_POR_BLOQUE columnas: se copian fila a fila a un buffer contiguo
+// y se transforman juntas (fft_ejecutar_lote), luego vuelven al espectro
+static void columnas(TrabajoFFT* t, int bloque, Complejo* espectro, int inversa) {
+    int ny = t->ny, mx = t->mx;
+    int c0 = bloque * COLUMNAS_POR_BLOQUE;
+    int nc = mx - c0 < COLUMNAS_POR_BLOQUE ? mx - c0 : COLUMNAS_POR_BLOQUE;
+
+    Complejo* buf = (Complejo*)malloc(sizeof(Complejo) * (size_t)ny * nc * 2);
+    if (!buf) {
+        atomic_store(&t->error, 1);
+        return;
+    }
+    Complejo* temp = buf + (size_t)ny * nc;
+
+    for (int y = 0; y < ny; y++) {
+        memcpy(buf + (size_t)y * nc, espectro + (size_t)y * mx + c0, sizeof(Complejo) * nc);
+    }
+    fft_ejecutar_lote(&t->plan_y, buf, temp, nc, inversa);
+    for (int y = 0; y < ny; y++) {
+        memcpy(espectro + (size_t)y * mx + c0, buf + (size_t)y * nc, sizeof(Complejo) * nc);
+    }
+
+    free(buf);
+}
+
+// Convolución = producto punto a punto de los espectros (una fila por tarea)
+static void producto(TrabajoFFT* t, int fila) {
+    Complejo* a = t->espectro_imagen + (size_t)fila * t->mx;
+    const Complejo* b = t->espectro_filtro + (size_t)fila * t->mx;
+    for (int k = 0; k < t->mx; k++) {
+        Complejo v = a[k];
+        a[k].re = v.re * b[k].re - v.im * b[k].im;
+        a[k].im = v.re * b[k].im + v.im * b[k].re;
+    }
+}
+
+// Inversa de dos filas de salida a la vez: Z = A + i*B completando la simetría
+// hermítica (A[n-k] = conj(A[k])); la parte real es una fila y la imaginaria la otra.
+static void filas_inversas(TrabajoFFT* t, int tarea) {
+    int nx = t->nx, mx = t->mx;
+    float escala = 1.0f / ((float)nx * (float)t->ny);
+
+    Complejo* z = (Complejo*)malloc(sizeof(Complejo) * nx * 2);
+    if (!z) {
+        atomic_store(&t->error, 1);
+        return;
+    }
+    Complejo* temp = z + nx;
+
+    int num_pares = (t->height + 1) / 2;
+    int q_fin = (tarea + 1) * PARES_POR_TAREA < num_pares ? (tarea + 1) * PARES_POR_TAREA : num_pares;
+
+    for (int q = tarea * PARES_POR_TAREA; q < q_fin; q++) {
+        int y0 = 2 * q, y1 = 2 * q + 1;
+        int hay_b = y1 < t->height;
+        const Complejo* fila_a = t->espectro_imagen + (size_t)(y0 + t->half) * mx;
+        const Complejo* fila_b = t->espectro_imagen + (size_t)(y1 + t->half) * mx;
+
+        for (int k = 0; k < nx; k++) {
+            Complejo a, b = { 0.0f, 0.0f };
+            if (k < mx) {
+                a = fila_a[k];
+                if (hay_b) b = fila_b[k];
+            } else {
+                a.re = fila_a[nx - k].re;
+                a.im = -fila_a[nx - k].im;
+                if (hay_b) {
+                    b.re = fila_b[nx - k].re;
+                    b.im = -fila_b[nx - k].im;
+                }
+            }
+            z[k].re = a.re - b.im;
+            z[k].im = a.im + b.re;
+        }
+        fft_ejecutar(&t->plan_x, z, temp, 1);
+
+        unsigned char* out0 = t->output + (size_t)y0 * t->pitch_salida;
+        for (int x = 0; x < t->width; x++) out0[x] = saturar(z[x + t->half].re * escala);
+        if (hay_b) {
+            unsigned char* out1 = t->output + (size_t)y1 * t->pitch_salida;
+            for (int x = 0; x < t->width; x++) out1[x] = saturar(z[x + t->half].im * escala);
+        }
+    }
+
+    free(z);
+}
+
+static void tarea_fft(void* contexto, int tarea) {
+    TrabajoFFT* t = (TrabajoFFT*)contexto;
+    switch (t->fase) {
+    case FASE_FILAS_IMAGEN:     filas_directas(t, tarea, 0); break;
+    case FASE_FILAS_FILTRO:     filas_directas(t, tarea, 1); break;
+    case FASE_COLUMNAS_IMAGEN:  columnas(t, tarea, t->espectro_imagen, 0); break;
+    case FASE_COLUMNAS_FILTRO:  columnas(t, tarea, t->espectro_filtro, 0); break;
+    case FASE_PRODUCTO:         producto(t, tarea); break;
+    case FASE_COLUMNAS_INVERSA: columnas(t, tarea, t->espectro_imagen, 1); break;
+    case FASE_FILAS_INVERSA:    filas_inversas(t, tarea); break;
+    }
+}
+
+// Ejecuta una fase en el pool, o en este hilo si pool es NULL
+static void ejecutar_fase(TrabajoFFT* t, PoolHilos* pool, FaseFFT fase, int num_tareas) {
+    t->fase = fase;
+    if (pool) {
+        pool_ejecutar(pool, num_tareas, tarea_fft, t);
+    } else {
+        for (int i = 0; i < num_tareas; i++) tarea_fft(t, i);
+    }
+}
+
+// ============================================
+// 3. Convolución completa
+// ============================================
+static int fft_convolucionar(const PlanoImagen* entrada, const PlanoImagen* salida,
+                             const float* kernel, int k_size, PoolHilos* pool) {
+    int width = entrada->width, height = entrada->height;
+    TrabajoFFT t = {
+        .input = entrada->datos,
+        .output = salida->datos,
+        .pitch_entrada = entrada->pitch,
+        .pitch_salida = salida->pitch,
+        .width = width,
+        .height = height,
+        .kernel = kernel,
+        .k_size = k_size,
+        .half = k_size / 2,
+    };
+    atomic_init(&t.error, 0);
+
+    t.nx = fft_tamano_rapido(width + 2 * t.half);
+    t.ny = fft_tamano_rapido(height + 2 * t.half);
+    t.mx = t.nx / 2 + 1;
+
+    int ok = fft_plan_crear(&t.plan_x, t.nx) && fft_plan_crear(&t.plan_y, t.ny);
+    t.espectro_imagen = (Complejo*)malloc(sizeof(Complejo) * (size_t)t.ny * t.mx);
+    t.espectro_filtro = (Complejo*)malloc(sizeof(Complejo) * (size_t)t.ny * t.mx);
+
+    if (ok && t.espectro_imagen && t.espectro_filtro) {
+        int tareas_filas = ((t.ny + 1) / 2 + PARES_POR_TAREA - 1) / PARES_POR_TAREA;
+        int tareas_columnas = (t.mx + COLUMNAS_POR_BLOQUE - 1) / COLUMNAS_POR_BLOQUE;
+        int tareas_salida = ((height + 1) / 2 + PARES_POR_TAREA - 1) / PARES_POR_TAREA;
+
+        ejecutar_fase(&t, pool, FASE_FILAS_IMAGEN, tareas_filas);
+        ejecutar_fase(&t, pool, FASE_FILAS_FILTRO, tareas_filas);
+        ejecutar_fase(&t, pool, FASE_COLUMNAS_IMAGEN, tareas_columnas);
+        ejecutar_fase(&t, pool, FASE_COLUMNAS_FILTRO, tareas_columnas);
+        ejecutar_fase(&t, pool, FASE_PRODUCTO, t.ny);
+        ejecutar_fase(&t, pool, FASE_COLUMNAS_INVERSA, tareas_columnas);
+        ejecutar_fase(&t, pool, FASE_FILAS_INVERSA, tareas_salida);
+        ok = !atomic_load(&t.error);
+    } else {
+        ok = 0;
+    }
+
+    free(t.espectro_imagen);
+    free(t.espectro_filtro);
+    fft_plan_liberar(&t.plan_x);
+    fft_plan_liberar(&t.plan_y);
+    return ok;
+}
+
+void convolucion_fft(const unsigned char* input, unsigned char* output,
+                     int width, int height, const float* kernel, int k_size) {
+    PlanoImagen entrada = { (unsigned char*)input, width, height, (size_t)width };
+    PlanoImagen salida = { output, width, height, (size_t)width };
+    convolucion_fft_plano(&entrada, &salida, kernel, k_size);
+}
+
+void convolucion_fft_plano(const PlanoImagen* entrada, const PlanoImagen* salida,
+                           const float* kernel, int k_size) {
+    int width = entrada->width, height = entrada->height;
+
+    PoolHilos* pool = pool_global();
+    if (!fft_convolucionar(entrada, salida, kernel, k_size, pool)) {
+        printf("Error: Fallo de memoria en la convolucion FFT.\n");
+        return;
+    }
+
+    int half = k_size / 2;
+    printf("[Info] Convolucion FFT: %d x %d puntos (imagen extendida %d x %d)\n",
+           fft_tamano_rapido(width + 2 * half), fft_tamano_rapido(height + 2 * half),
+           width + 2 * half, height + 2 * half);
+}
+
+// ============================================
+// 4. Cruce directo / FFT
+// ============================================
+static CalibracionFFT calibracion_cpu;
+static pthread_once_t calibracion_cpu_once = PTHREAD_ONCE_INIT;
+
+static void calibrar_cpu(void) {
+    int lado = CALIBRACION_LADO, k = CALIBRACION_K;
+    unsigned char* img = (unsigned char*)malloc((size_t)lado * lado * 2);
+    float* filtro = (float*)malloc(sizeof(float) * k * k);
+
+    // Valores por defecto razonables si no hay memoria para medir
+    calibracion_cpu.ns_por_tap = 0.1;
+    calibracion_cpu.ns_por_punto = 2.0;
+    if (!img || !filtro) {
+        free(img);
+        free(filtro);
+        return;
+    }
+
+    // Imagen y filtro pseudoaleatorios (el filtro no es separable ni de caja)
+    unsigned int semilla = 12345;
+    for (int i = 0; i < lado * lado; i++) {
+        img[i] = (unsigned char)aleatorio_siguiente(&semilla);
+    }
+    for (int i = 0; i < k * k; i++) {
+        filtro[i] = (float)(aleatorio_siguiente(&semilla) & 0xFF) / (255.0f * k * k);
+    }
+
+    double mejor_directo = 1e30, mejor_fft = 1e30;
+    unsigned char* out = img + (size_t)lado * lado;
+    PlanoImagen plano_img = { img, lado, lado, (size_t)lado };
+    PlanoImagen plano_out = { out, lado, lado, (size_t)lado };
+    for (int rep = 0; rep < CALIBRACION_REPETICIONES; rep++) {
+        double t0 = reloj_ms();
+        convolucion_simd_filas(img, out, lado, lado, filtro, k, 0, lado);
+        double t1 = reloj_ms();
+        fft_convolucionar(&plano_img, &plano_out, filtro, k, NULL);
+        double t2 = reloj_ms();
+
+        if (t1 - t0 < mejor_directo) mejor_directo = t1 - t0;
+        if (t2 - t1 < mejor_fft) mejor_fft = t2 - t1;
+    }
+
+    calibracion_cpu.ns_por_tap = mejor_directo * 1e6 / ((double)lado * lado * k * k);
+    calibracion_cpu.ns_por_punto = mejor_fft * 1e6 / fft_coste_puntos(lado, lado, k);
+    printf("[Info] Calibracion FFT (CPU): directo %.4f ns/tap, FFT %.3f ns/punto\n",
+           calibracion_cpu.ns_por_tap, calibracion_cpu.ns_por_punto);
+
+    free(img);
+    free(filtro);
+}
+
+const CalibracionFFT* fft_calibracion_cpu(void) {
+    pthread_once(&calibracion_cpu_once, calibrar_cpu);
+    return &calibracion_cpu;
+}
+
+double fft_coste_puntos(int width, int height, int k_size) {
+    int half = k_size / 2;
+    double puntos = (double)fft_tamano_rapido(width + 2 * half) * fft_tamano_rapido(height + 2 * half);
+    return puntos * log2(puntos);
+}
+
+int fft_conviene(const CalibracionFFT* calibracion, int width, int height, int k_size) {
+    if (k_size < FILTRO_K_MIN_FFT) return 0;
+
+    double directo = calibracion->ns_por_tap * (double)width * height * k_size * k_size;
+    double fft = calibracion->ns_por_punto * fft_coste_puntos(width, height, k_size);
+    return fft < directo;
+}
@@ -0,0 +1,75 @@
+#include "convolucion_hilos.h"
+#include "convolucion_simd.h"
+#include "pool_hilos.h"
+#include "progreso.h"
+
+#include <stdio.h>
+
+// Tamaño máximo de banda: con bandas pequeñas el robo de trabajo reparte mejor,
+// pero cada banda relee k_size - 1 filas de halo de sus vecinas.
+#define FILAS_POR_BANDA_MAX 16
+// Bandas por hilo que se buscan como mínimo (margen para equilibrar la carga)
+#define BANDAS_POR_HILO 8
+
+// Todo lo que necesita una banda; vive en la pila de convolucion_hilos()
+typedef struct {
+    PlanoImagen entrada;
+    PlanoImagen salida;
+    const float* kernel;
+    int k_size;
+    int filas_banda;
+    Progreso progreso;
+} TrabajoConvolucion;
+
+static void procesar_banda(void* contexto, int banda) {
+    TrabajoConvolucion* t = (TrabajoConvolucion*)contexto;
+
+    int y_ini = banda * t->filas_banda;
+    int y_fin = y_ini + t->filas_banda;
+    if (y_fin > t->entrada.height) y_fin = t->entrada.height;
+
+    convolucion_simd_plano_filas(&t->entrada, &t->salida, t->kernel, t->k_size, y_ini, y_fin);
+    progreso_avanzar(&t->progreso, y_fin - y_ini);
+}
+
+void convolucion_hilos(const unsigned char* input, unsigned char* output,
+                       int width, int height, const float* kernel, int k_size) {
+    PlanoImagen entrada = { (unsigned char*)input, width, height, (size_t)width };
+    PlanoImagen salida = { output, width, height, (size_t)width };
+    convolucion_hilos_plano(&entrada, &salida, kernel, k_size);
+}
+
+void convolucion_hilos_plano(const PlanoImagen* entrada, const PlanoImagen* salida,
+                             const float* kernel, int k_size) {
+    int height = entrada->height;
+
+    PoolHilos* pool = pool_global();
+    if (!pool) {
+        // Sin hilos disponibles: mismo resultado en un solo hilo
+        convolucion_simd_plano(entrada, salida, kernel, k_size);
+        return;
+    }
+
+    // Detectar la CPU antes de repartir (evita que los hilos compitan por la caché de CPUID)
+    simd_nivel_detectado();
+
+    int num_hilos = pool_num_hilos(pool);
+    int filas_banda = height / (num_hilos * BANDAS_POR_HILO);
+    if (filas_banda < 1) filas_banda = 1;
+    if (filas_banda > FILAS_POR_BANDA_MAX) filas_banda = FILAS_POR_BANDA_MAX;
+
+    TrabajoConvolucion trabajo = {
+        .entrada = *entrada,
+        .salida = *salida,
+        .kernel = kernel,
+        .k_size = k_size,
+        .filas_banda = filas_banda,
+    };
+    progreso_iniciar(&trabajo.progreso, height);
+
+    int num_bandas = (height + filas_banda - 1) / filas_banda;
+    pool_ejecutar(pool, num_bandas, procesar_banda, &trabajo);
+
+    progreso_finalizar(&trabajo.progreso);
+    printf("[Info] %d hilos, %d bandas de %d filas\n", num_hilos, num_bandas, filas_banda);
+}
@@ -1,126 +1,1401 @@
 #include "convolucion_paralelo.h"
+#include "ajuste_grupos.h"
+#include "aleatorio.h"
+#include "convolucion_fft.h"
+#include "fft_opencl.h"
+#include "filtro.h"
+#include <math.h>
+#include <pthread.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 
-void convolucion_paralelo(CLManager* mgr, const unsigned char* input, unsigned char* output,
-                              int width, int height, const float* filter, int k_size, double* kernel_time_ms) {
+// Lado preferido del work-group de conv2d_tiles (TILE x TILE work-items)
+#define CONV_TILE 16
+
+// Tamaño máximo del work-group del scan por filas del filtro de caja
+#define CAJA_GRUPO_MAX 256
+
+// Filas que recorre cada work-item en la pasada vertical del filtro de caja
+#define CAJA_FILAS_POR_ITEM 64
+
+// Imagen y filtro sintéticos para calibrar el cruce directo / FFT en cada dispositivo
+#define CALIBRACION_LADO 512
+#define CALIBRACION_K 21
+#define CALIBRACION_REPETICIONES 2
+#define MAX_DISPOSITIVOS_CALIBRADOS 8
+
+// Formatos de imagen que se consultan al comprobar el soporte de CL_R / CL_UNORM_INT8
+#define MAX_FORMATOS_IMAGEN 64
+
+// Mayor filtro cuyos pesos se fijan como constantes con CONV_ESPECIALIZAR=pesos
+// (cada filtro distinto es un programa más que compilar)
+#define CONV_PESOS_FIJOS_K_MAX 9
+
+// Tiempo de ejecución en GPU de un comando ya terminado (profiling), en ms
+static double tiempo_evento_ms(cl_event evento) {
+    cl_ulong time_start, time_end;
+    clGetEventProfilingInfo(evento, CL_PROFILING_COMMAND_START, sizeof(time_start), &time_start, NULL);
+    clGetEventProfilingInfo(evento, CL_PROFILING_COMMAND_END, sizeof(time_end), &time_end, NULL);
+    return (double)(time_end - time_start) / 1000000.0;
+}
+
+// Desde el inicio de 'primero' hasta el final de 'ultimo' (ya terminados), en ms
+static double tiempo_eventos_ms(cl_event primero, cl_event ultimo) {
+    cl_ulong time_start, time_end;
+    clGetEventProfilingInfo(primero, CL_PROFILING_COMMAND_START, sizeof(time_start), &time_start, NULL);
+    clGetEventProfilingInfo(ultimo, CL_PROFILING_COMMAND_END, sizeof(time_end), &time_end, NULL);
+    return (double)(time_end - time_start) / 1000000.0;
+}
 
+// Configura los 6 argumentos comunes (input, output, pesos, width, height, ksize) y encola el kernel
+static cl_int encolar_filtro(CLManager* mgr, cl_kernel kernel, cl_mem entrada, cl_mem salida, cl_mem pesos,
+                             int width, int height, int k_size, cl_event* evento) {
     cl_int err;
-    cl_event prof_event; //
+    err  = clSetKernelArg(kernel, 0, sizeof(cl_mem), &entrada);
+    err |= clSetKernelArg(kernel, 1, sizeof(cl_mem), &salida);
+    err |= clSetKernelArg(kernel, 2, sizeof(cl_mem), &pesos);
+    err |= clSetKernelArg(kernel, 3, sizeof(int), &width);
+    err |= clSetKernelArg(kernel, 4, sizeof(int), &height);
+    err |= clSetKernelArg(kernel, 5, sizeof(int), &k_size);
+    if (err != CL_SUCCESS) return err;
 
-    // 1. Convertir entrada a float (Mejor precisión en GPU)
-    // ----------------------------------------------------
-    size_t num_pixels = width * height;
-    size_t img_size_bytes = num_pixels * sizeof(float);
+    size_t global_work_size[2] = { (size_t)width, (size_t)height };
+    return clEnqueueNDRangeKernel(mgr->queue, kernel, 2, NULL, global_work_size, NULL, 0, NULL, evento);
+}
+
+// Variantes de la convolución directa. 'nombre' es su clave en la base de ajuste;
+// conv2d_bloques calcula bloque_x x bloque_y píxeles por work-item (register
+// blocking, fijado al compilar con -D BLOQUE_X / -D BLOQUE_Y). Con interior_borde
+// el kernel solo cubre el interior (sin clamp) y conv2d_borde completa las franjas.
+typedef struct {
+    const char* nombre;
+    const char* kernel;
+    int usar_tiles;
+    int bloque_x, bloque_y;
+    int interior_borde;
+} VarianteConv2d;
+
+// conv2d_imagen no está en la tabla: lee una image2d_t en lugar de un buffer
+// (ver convolucion_paralelo_imagen)
+static const VarianteConv2d variante_imagen = { "conv2d_imagen", "conv2d_imagen", 0, 1, 1, 0 };
+
+// Franjas de borde de las variantes con interior_borde (no se lanza sola)
+static const VarianteConv2d variante_borde = { "conv2d_borde", "conv2d_borde", 0, 1, 1, 0 };
 
-    float* host_input_float = (float*)malloc(img_size_bytes);
-    float* host_output_float = (float*)malloc(img_size_bytes);
+enum { V_CONV2D, V_TILES, V_BLOQUES_4X1, V_BLOQUES_8X1, V_BLOQUES_4X4, V_INTERIOR, NUM_VARIANTES_CONV2D };
 
-    if (!host_input_float || !host_output_float) {
-        printf("Error: Fallo de memoria en conversion float.\n");
-        return;
+static const VarianteConv2d variantes_conv2d[NUM_VARIANTES_CONV2D] = {
+    { "conv2d",          "conv2d",          0, 1, 1, 0 },
+    { "conv2d_tiles",    "conv2d_tiles",    1, 1, 1, 0 },
+    { "conv2d_b4x1",     "conv2d_bloques",  0, 4, 1, 0 },
+    { "conv2d_b8x1",     "conv2d_bloques",  0, 8, 1, 0 },
+    { "conv2d_b4x4",     "conv2d_bloques",  0, 4, 4, 0 },
+    { "conv2d_interior", "conv2d_interior", 0, 1, 1, 1 },
+};
+
+// Variante y work-group con que se lanzó una convolución directa ({0, 0} = el del runtime)
+typedef struct {
+    const VarianteConv2d* variante;
+    size_t local[2];
+} LanzamientoConv2d;
+
+static int usa_bloques(const VarianteConv2d* v) {
+    return v->bloque_x * v->bloque_y > 1;
+}
+
+// Kernel de la variante 'v' compilado para k_size (-D KSIZE, ver
+// CLManager_GetKernelVariante): el compilador desenrolla los bucles del filtro.
+// CONV_ESPECIALIZAR=0 usa el kernel genérico; CONV_ESPECIALIZAR=pesos fija además
+// los pesos de 'filtro' (si k_size <= CONV_PESOS_FIJOS_K_MAX) como constantes. Con
+// pesos los valores forman parte de las opciones (la clave de la caché de variantes):
+// cada filtro nuevo compila un programa propio y, con las CL_MANAGER_MAX_VARIANTES
+// ocupadas, desaloja por LRU variantes -D KSIZE que se vuelven a compilar al reusarse.
+// La calibración y el ajuste usan pesos sintéticos y pasan 'filtro' NULL (solo -D KSIZE).
+// Las variantes sin bloques vuelven a su kernel genérico si la especializada no compila;
+// conv2d_bloques siempre se compila con su bloque y devuelve NULL si no se puede.
+static cl_kernel kernel_conv2d(CLManager* mgr, const VarianteConv2d* v, const float* filtro, int k_size) {
+    int bloques = usa_bloques(v);
+    cl_kernel generico = bloques ? NULL : strcmp(v->kernel, "conv2d") == 0 ? mgr->kernel : CLManager_GetKernel(mgr, v->kernel);
+    const char* modo = getenv("CONV_ESPECIALIZAR");
+    int especializar = !(modo && strcmp(modo, "0") == 0);
+    if (!bloques && (!generico || !especializar)) return generico;
+
+    // 1. Pesos fijos solo si todos se pueden escribir como literal ("%.9e" conserva el float exacto)
+    int fijar_pesos = modo && strcmp(modo, "pesos") == 0 && filtro && k_size <= CONV_PESOS_FIJOS_K_MAX;
+    for (int i = 0; fijar_pesos && i < k_size * k_size; i++) {
+        if (!isfinite(filtro[i])) fijar_pesos = 0;
     }
 
-    for(size_t i = 0; i < num_pixels; i++) {
-        host_input_float[i] = (float)input[i];
+    // 2. Opciones de build: la clave de la variante
+    char opciones[64 + CONV_PESOS_FIJOS_K_MAX * CONV_PESOS_FIJOS_K_MAX * 20];
+    int n = 0;
+    opciones[0] = '\0';
+    if (especializar) n += snprintf(opciones + n, sizeof(opciones) - n, "-D KSIZE=%d", k_size);
+    if (bloques) {
+        n += snprintf(opciones + n, sizeof(opciones) - n, "%s-D BLOQUE_X=%d -D BLOQUE_Y=%d",
+                      n ? " " : "", v->bloque_x, v->bloque_y);
+    }
+    if (fijar_pesos) {
+        n += snprintf(opciones + n, sizeof(opciones) - n, " -D PESOS=");
+        for (int i = 0; i < k_size * k_size; i++) {
+            n += snprintf(opciones + n, sizeof(opciones) - n, "%s%.9ef", i ? "," : "", filtro[i]);
+        }
     }
 
-    // 2. Crear Buffers en la GPU
-    // ----------------------------------------------------
-    // Buffer Entrada (Copiamos desde el host inmediatamente)
-    cl_mem d_input = clCreateBuffer(mgr->context, CL_MEM_READ_ONLY | CL_MEM_COPY_HOST_PTR,
-                                    img_size_bytes, host_input_float, &err);
+    cl_kernel kernel = CLManager_GetKernelVariante(mgr, v->kernel, opciones);
+    return kernel ? kernel : generico;
+}
 
-    // Buffer Salida (Solo escritura)
-    cl_mem d_output = clCreateBuffer(mgr->context, CL_MEM_WRITE_ONLY,
-                                     img_size_bytes, NULL, &err);
+void convolucion_paralelo_especializar(CLManager* mgr, const float* filter, int k_size) {
+    // conv2d y conv2d_tiles comparten programa; los bloques por defecto dependen del dispositivo
+    cl_device_type tipo = CL_DEVICE_TYPE_GPU;
+    clGetDeviceInfo(mgr->device_id, CL_DEVICE_TYPE, sizeof(tipo), &tipo, NULL);
+    kernel_conv2d(mgr, &variantes_conv2d[V_CONV2D], filter, k_size);
+    kernel_conv2d(mgr, &variantes_conv2d[(tipo & CL_DEVICE_TYPE_CPU) ? V_BLOQUES_4X4 : V_BLOQUES_4X1], filter, k_size);
+}
 
-    // Buffer Filtro/Kernel (Copiamos desde el host)
-    cl_mem d_filter = clCreateBuffer(mgr->context, CL_MEM_READ_ONLY | CL_MEM_COPY_HOST_PTR,
-                                     sizeof(float) * k_size * k_size, (void*)filter, &err);
+// conv2d (sin tiles) sobre la región [x, x + width) x [y, y + height) de la imagen, con
+// global_work_offset = (x, y): cada work-item escribe exactamente un píxel de la región
+// (conv2d_tiles necesita un global múltiplo del tile y escribiría fuera de ella).
+// 'filtro' son los pesos en el host (kernel_conv2d).
+static cl_int encolar_conv2d_region(CLManager* mgr, cl_mem entrada, cl_mem salida, cl_mem pesos, const float* filtro,
+                                    int width, int height, int pitch_entrada, int pitch_salida, int k_size,
+                                    const RegionROI* region, cl_event* evento) {
+    cl_kernel kernel = kernel_conv2d(mgr, &variantes_conv2d[V_CONV2D], filtro, k_size);
+    cl_int err;
+    err  = clSetKernelArg(kernel, 0, sizeof(cl_mem), &entrada);
+    err |= clSetKernelArg(kernel, 1, sizeof(cl_mem), &salida);
+    err |= clSetKernelArg(kernel, 2, sizeof(cl_mem), &pesos);
+    err |= clSetKernelArg(kernel, 3, sizeof(int), &width);
+    err |= clSetKernelArg(kernel, 4, sizeof(int), &height);
+    err |= clSetKernelArg(kernel, 5, sizeof(int), &k_size);
+    err |= clSetKernelArg(kernel, 6, sizeof(int), &pitch_entrada);
+    err |= clSetKernelArg(kernel, 7, sizeof(int), &pitch_salida);
+    if (err != CL_SUCCESS) return err;
 
-    if (err != CL_SUCCESS) {
-        printf("Error creando buffers OpenCL (Code %d)\n", err);
-        goto cleanup; // Salto a limpieza
+    size_t global_work_offset[2] = { (size_t)region->x, (size_t)region->y };
+    size_t global_work_size[2] = { (size_t)region->width, (size_t)region->height };
+    return clEnqueueNDRangeKernel(mgr->queue, kernel, 2, global_work_offset, global_work_size, NULL,
+                                  0, NULL, evento);
+}
+
+// Bytes de memoria local del tile con halo de conv2d_tiles para un work-group 'local'
+static size_t bytes_tile(const size_t local[2], int k_size) {
+    return sizeof(float) * (local[0] + (size_t)k_size - 1) * (local[1] + (size_t)k_size - 1);
+}
+
+// 1 si el dispositivo admite lanzar 'kernel' con work-groups 'local' que usan
+// 'bytes_local' bytes de memoria local
+static int local_valido(CLManager* mgr, cl_kernel kernel, const size_t local[2], size_t bytes_local) {
+    size_t max_grupo = 0;
+    size_t max_items[3] = { 0, 0, 0 };
+    cl_ulong memoria_local = 0;
+    clGetKernelWorkGroupInfo(kernel, mgr->device_id, CL_KERNEL_WORK_GROUP_SIZE, sizeof(max_grupo), &max_grupo, NULL);
+    clGetDeviceInfo(mgr->device_id, CL_DEVICE_MAX_WORK_ITEM_SIZES, sizeof(max_items), max_items, NULL);
+    clGetDeviceInfo(mgr->device_id, CL_DEVICE_LOCAL_MEM_SIZE, sizeof(memoria_local), &memoria_local, NULL);
+    return local[0] > 0 && local[1] > 0 && local[0] * local[1] <= max_grupo &&
+           local[0] <= max_items[0] && local[1] <= max_items[1] && bytes_local <= memoria_local;
+}
+
+// Configura los 8 argumentos de conv2d_interior / conv2d_borde (los de conv2d)
+static cl_int argumentos_conv2d(cl_kernel kernel, cl_mem entrada, cl_mem salida, cl_mem pesos,
+                                int width, int height, int pitch_entrada, int pitch_salida, int k_size) {
+    cl_int err;
+    err  = clSetKernelArg(kernel, 0, sizeof(cl_mem), &entrada);
+    err |= clSetKernelArg(kernel, 1, sizeof(cl_mem), &salida);
+    err |= clSetKernelArg(kernel, 2, sizeof(cl_mem), &pesos);
+    err |= clSetKernelArg(kernel, 3, sizeof(int), &width);
+    err |= clSetKernelArg(kernel, 4, sizeof(int), &height);
+    err |= clSetKernelArg(kernel, 5, sizeof(int), &k_size);
+    err |= clSetKernelArg(kernel, 6, sizeof(int), &pitch_entrada);
+    err |= clSetKernelArg(kernel, 7, sizeof(int), &pitch_salida);
+    return err;
+}
+
+// Variante interior + borde: conv2d_interior sobre el rectángulo donde la ventana no
+// sale de la imagen (global_work_offset = (half, half), work-group 'local' o el del
+// runtime) y después conv2d_borde sobre las franjas, un work-item por píxel. Si una
+// de las dos partes queda vacía (k_size = 1 o imágenes de menos de k_size de lado)
+// se lanza solo la otra y *ultimo es el mismo evento que *primero. Si algo falla
+// devuelve el error con *primero y *ultimo a NULL (el interior ya encolado se
+// libera aquí).
+static cl_int encolar_conv2d_interior_borde(CLManager* mgr, const VarianteConv2d* v, const size_t local[2],
+                                            cl_mem entrada, cl_mem salida, cl_mem pesos, const float* filtro,
+                                            int width, int height, int pitch_entrada, int pitch_salida,
+                                            int k_size, cl_event* primero, cl_event* ultimo) {
+    cl_kernel k_interior = kernel_conv2d(mgr, v, filtro, k_size);
+    cl_kernel k_borde = kernel_conv2d(mgr, &variante_borde, filtro, k_size);
+    if (!k_interior || !k_borde) return CL_INVALID_KERNEL_NAME;
+
+    // 1. Geometría (la misma que recorre conv2d_borde)
+    int half = k_size / 2;
+    int arriba = half < height ? half : height;
+    int abajo = half < height - arriba ? half : height - arriba;
+    int izquierda = half < width ? half : width;
+    int derecha = half < width - izquierda ? half : width - izquierda;
+    size_t ancho_interior = (size_t)(width - izquierda - derecha);
+    size_t alto_interior = (size_t)(height - arriba - abajo);
+    size_t pixeles_borde = (size_t)(arriba + abajo) * width + alto_interior * (size_t)(izquierda + derecha);
+
+    cl_int err = CL_SUCCESS;
+    cl_event* evento = primero;
+    *primero = NULL;
+    *ultimo = NULL;
+
+    // 2. Interior sin clamp
+    if (ancho_interior > 0 && alto_interior > 0) {
+        err = argumentos_conv2d(k_interior, entrada, salida, pesos, width, height, pitch_entrada, pitch_salida, k_size);
+        if (err != CL_SUCCESS) return err;
+
+        size_t global_work_offset[2] = { (size_t)half, (size_t)half };
+        size_t global_work_size[2] = { ancho_interior, alto_interior };
+        if (local) {
+            global_work_size[0] = (global_work_size[0] + local[0] - 1) / local[0] * local[0];
+            global_work_size[1] = (global_work_size[1] + local[1] - 1) / local[1] * local[1];
+        }
+        err = clEnqueueNDRangeKernel(mgr->queue, k_interior, 2, global_work_offset, global_work_size, local,
+                                     0, NULL, evento);
+        if (err != CL_SUCCESS) return err;
+        evento = ultimo;
     }
 
-    // 3. Configurar Argumentos del Kernel
-    // ----------------------------------------------------
-    // El orden debe coincidir con __kernel void conv2d en convolucion.cl
-    err  = clSetKernelArg(mgr->kernel, 0, sizeof(cl_mem), &d_input);
-    err |= clSetKernelArg(mgr->kernel, 1, sizeof(cl_mem), &d_output);
-    err |= clSetKernelArg(mgr->kernel, 2, sizeof(cl_mem), &d_filter);
-    err |= clSetKernelArg(mgr->kernel, 3, sizeof(int), &width);
-    err |= clSetKernelArg(mgr->kernel, 4, sizeof(int), &height);
-    err |= clSetKernelArg(mgr->kernel, 5, sizeof(int), &k_size);
+    // 3. Franjas de borde
+    if (pixeles_borde > 0) {
+        err = argumentos_conv2d(k_borde, entrada, salida, pesos, width, height, pitch_entrada, pitch_salida, k_size);
+        if (err == CL_SUCCESS) {
+            err = clEnqueueNDRangeKernel(mgr->queue, k_borde, 1, NULL, &pixeles_borde, NULL, 0, NULL, evento);
+        }
+        if (err != CL_SUCCESS) {
+            if (*primero) clReleaseEvent(*primero);
+            *primero = NULL;
+            *ultimo = NULL;
+            return err;
+        }
+    }
+
+    // 4. Una sola parte: primero y último son el mismo comando
+    if (!*ultimo) {
+        clRetainEvent(*primero);
+        *ultimo = *primero;
+    }
+    return CL_SUCCESS;
+}
+
+// Encola la variante 'v' sobre la imagen completa: un work-item por bloque de
+// bloque_x x bloque_y píxeles, con el work-group 'local' y el global redondeado a
+// múltiplo de él (los work-items que sobran no escriben). local = NULL: el que
+// elija OpenCL (no vale para conv2d_tiles, que dimensiona su tile con él).
+// En *primero / *ultimo el primer y el último kernel encolados (el mismo evento,
+// retenido dos veces, salvo en las variantes interior + borde). Si devuelve un
+// error no queda ningún evento que liberar.
+static cl_int encolar_conv2d_local(CLManager* mgr, const VarianteConv2d* v, const size_t local[2],
+                                   cl_mem entrada, cl_mem salida, cl_mem pesos, const float* filtro,
+                                   int width, int height, int pitch_entrada, int pitch_salida, int k_size,
+                                   cl_event* primero, cl_event* ultimo) {
+    if (v->interior_borde) {
+        return encolar_conv2d_interior_borde(mgr, v, local, entrada, salida, pesos, filtro, width, height,
+                                             pitch_entrada, pitch_salida, k_size, primero, ultimo);
+    }
+    cl_kernel kernel = kernel_conv2d(mgr, v, filtro, k_size);
+    if (!kernel) return CL_INVALID_KERNEL_NAME;
+    if (v->usar_tiles && !local) return CL_INVALID_WORK_GROUP_SIZE;
+
+    // conv2d_tiles recibe el tile en memoria local entre los pesos y width
+    int arg = 0;
+    cl_int err;
+    err  = clSetKernelArg(kernel, arg++, sizeof(cl_mem), &entrada);
+    err |= clSetKernelArg(kernel, arg++, sizeof(cl_mem), &salida);
+    err |= clSetKernelArg(kernel, arg++, sizeof(cl_mem), &pesos);
+    if (v->usar_tiles) err |= clSetKernelArg(kernel, arg++, bytes_tile(local, k_size), NULL);
+    err |= clSetKernelArg(kernel, arg++, sizeof(int), &width);
+    err |= clSetKernelArg(kernel, arg++, sizeof(int), &height);
+    err |= clSetKernelArg(kernel, arg++, sizeof(int), &k_size);
+    err |= clSetKernelArg(kernel, arg++, sizeof(int), &pitch_entrada);
+    err |= clSetKernelArg(kernel, arg++, sizeof(int), &pitch_salida);
+    if (err != CL_SUCCESS) return err;
+
+    size_t global_work_size[2] = { (size_t)(width + v->bloque_x - 1) / v->bloque_x,
+                                   (size_t)(height + v->bloque_y - 1) / v->bloque_y };
+    if (local) {
+        global_work_size[0] = (global_work_size[0] + local[0] - 1) / local[0] * local[0];
+        global_work_size[1] = (global_work_size[1] + local[1] - 1) / local[1] * local[1];
+    }
+    err = clEnqueueNDRangeKernel(mgr->queue, kernel, 2, NULL, global_work_size, local, 0, NULL, primero);
+    if (err != CL_SUCCESS) return err;
+    clRetainEvent(*primero);
+    *ultimo = *primero;
+    return CL_SUCCESS;
+}
+
+// Convolución 2D directa. La variante y el work-group salen de la base de ajuste
+// (ver ajuste_grupos.h): de las variantes ajustadas para este dispositivo, clase de
+// imagen y k_size se lanza la más rápida. Sin ajuste, en GPU conv2d_tiles con
+// CONV_TILE x CONV_TILE si el tile con halo cabe en memoria local y si no bloques
+// de 4x1 (menos registros por work-item); en CPU bloques de 4x4 (los runtimes de CPU
+// emulan la memoria local y las barreras, y 4x4 es el bloque que más lecturas
+// reutiliza). Si lo anterior no se puede lanzar, conv2d_interior + conv2d_borde y en
+// último caso conv2d, con el local que elija OpenCL. Los pitch son la distancia entre
+// filas (en píxeles) de entrada y salida. *primero / *ultimo como en encolar_conv2d_local.
+// En *lanzado la variante y el work-group usados (puede ser NULL).
+static cl_int encolar_conv2d(CLManager* mgr, cl_mem entrada, cl_mem salida, cl_mem pesos, const float* filtro,
+                             int width, int height, int pitch_entrada, int pitch_salida, int k_size,
+                             cl_event* primero, cl_event* ultimo, LanzamientoConv2d* lanzado) {
+    const VarianteConv2d* elegida = NULL;
+    size_t local[2] = { 0, 0 };
+    double mejor_ms = -1.0;
+
+    // 1. La variante ajustada más rápida que se pueda lanzar
+    for (int i = 0; i < NUM_VARIANTES_CONV2D; i++) {
+        const VarianteConv2d* v = &variantes_conv2d[i];
+        size_t ajustado[2];
+        double ms;
+        if (!ajuste_buscar(mgr->device_id, v->nombre, width, height, k_size, ajustado, &ms)) continue;
+        if (mejor_ms >= 0.0 && ms >= mejor_ms) continue;
+
+        cl_kernel kernel = kernel_conv2d(mgr, v, filtro, k_size);
+        size_t bytes_local = v->usar_tiles ? bytes_tile(ajustado, k_size) : 0;
+        int del_runtime = ajustado[0] == 0 && !v->usar_tiles;
+        if (!kernel || (!del_runtime && !local_valido(mgr, kernel, ajustado, bytes_local))) continue;
+        if (v->interior_borde && !kernel_conv2d(mgr, &variante_borde, filtro, k_size)) continue;
+        elegida = v;
+        local[0] = ajustado[0];
+        local[1] = ajustado[1];
+        mejor_ms = ms;
+    }
+
+    // 2. Sin ajuste: según el tipo de dispositivo
+    if (!elegida) {
+        cl_device_type tipo = CL_DEVICE_TYPE_GPU;
+        clGetDeviceInfo(mgr->device_id, CL_DEVICE_TYPE, sizeof(tipo), &tipo, NULL);
+        int cpu = (tipo & CL_DEVICE_TYPE_CPU) != 0;
+        cl_kernel kernel = cpu ? NULL : kernel_conv2d(mgr, &variantes_conv2d[V_TILES], filtro, k_size);
+        if (kernel) {
+            // El mayor TILE x TILE que admite el dispositivo, si el tile con halo cabe en memoria local
+            size_t max_grupo = 0;
+            clGetKernelWorkGroupInfo(kernel, mgr->device_id, CL_KERNEL_WORK_GROUP_SIZE, sizeof(max_grupo), &max_grupo, NULL);
+            size_t tile = CONV_TILE;
+            while (tile > 1 && tile * tile > max_grupo) tile /= 2;
+            size_t candidato[2] = { tile, tile };
+            if (tile * tile >= 16 && local_valido(mgr, kernel, candidato, bytes_tile(candidato, k_size))) {
+                elegida = &variantes_conv2d[V_TILES];
+                local[0] = local[1] = tile;
+            }
+        }
+        if (!elegida) {
+            const VarianteConv2d* bloques = &variantes_conv2d[cpu ? V_BLOQUES_4X4 : V_BLOQUES_4X1];
+            const VarianteConv2d* interior = &variantes_conv2d[V_INTERIOR];
+            if (kernel_conv2d(mgr, bloques, filtro, k_size)) {
+                elegida = bloques;
+            } else if (kernel_conv2d(mgr, interior, filtro, k_size) && kernel_conv2d(mgr, &variante_borde, filtro, k_size)) {
+                elegida = interior;
+            } else {
+                elegida = &variantes_conv2d[V_CONV2D];
+            }
+        }
+    }
+
+    if (lanzado) {
+        lanzado->variante = elegida;
+        lanzado->local[0] = local[0];
+        lanzado->local[1] = local[1];
+    }
+    return encolar_conv2d_local(mgr, elegida, local[0] ? local : NULL, entrada, salida, pesos, filtro,
+                                width, height, pitch_entrada, pitch_salida, k_size, primero, ultimo);
+}
+
+// Filtro de caja en dos kernels: scan por filas (caja_filas) y ventana vertical (caja_columnas).
+// d_prefijo y d_horizontal son buffers de width * height uint.
+static cl_int encolar_caja(CLManager* mgr, cl_mem d_input, cl_mem d_output, cl_mem d_prefijo, cl_mem d_horizontal,
+                           int width, int height, int k_size, float peso, cl_event* ev_filas, cl_event* ev_columnas) {
+    cl_kernel k_filas = CLManager_GetKernel(mgr, "caja_filas");
+    cl_kernel k_columnas = CLManager_GetKernel(mgr, "caja_columnas");
+    if (!k_filas || !k_columnas) return CL_INVALID_KERNEL_NAME;
+
+    // 1. Un work-group por fila; el scan necesita un tamaño potencia de 2
+    size_t max_grupo = 1;
+    clGetKernelWorkGroupInfo(k_filas, mgr->device_id, CL_KERNEL_WORK_GROUP_SIZE, sizeof(max_grupo), &max_grupo, NULL);
+    size_t grupo = 1;
+    while (grupo * 2 <= max_grupo && grupo * 2 <= CAJA_GRUPO_MAX) grupo *= 2;
+
+    cl_int err;
+    err  = clSetKernelArg(k_filas, 0, sizeof(cl_mem), &d_input);
+    err |= clSetKernelArg(k_filas, 1, sizeof(cl_mem), &d_prefijo);
+    err |= clSetKernelArg(k_filas, 2, sizeof(cl_mem), &d_horizontal);
+    err |= clSetKernelArg(k_filas, 3, sizeof(cl_uint) * grupo, NULL);
+    err |= clSetKernelArg(k_filas, 4, sizeof(int), &width);
+    err |= clSetKernelArg(k_filas, 5, sizeof(int), &height);
+    err |= clSetKernelArg(k_filas, 6, sizeof(int), &k_size);
+    if (err != CL_SUCCESS) return err;
+
+    size_t global_filas[2] = { grupo, (size_t)height };
+    size_t local_filas[2] = { grupo, 1 };
+    err = clEnqueueNDRangeKernel(mgr->queue, k_filas, 2, NULL, global_filas, local_filas, 0, NULL, ev_filas);
+    if (err != CL_SUCCESS) return err;
+
+    // 2. Un work-item por columna y tramo de CAJA_FILAS_POR_ITEM filas
+    int filas_por_item = CAJA_FILAS_POR_ITEM;
+    err  = clSetKernelArg(k_columnas, 0, sizeof(cl_mem), &d_horizontal);
+    err |= clSetKernelArg(k_columnas, 1, sizeof(cl_mem), &d_output);
+    err |= clSetKernelArg(k_columnas, 2, sizeof(float), &peso);
+    err |= clSetKernelArg(k_columnas, 3, sizeof(int), &width);
+    err |= clSetKernelArg(k_columnas, 4, sizeof(int), &height);
+    err |= clSetKernelArg(k_columnas, 5, sizeof(int), &k_size);
+    err |= clSetKernelArg(k_columnas, 6, sizeof(int), &filas_por_item);
+    if (err != CL_SUCCESS) return err;
+
+    size_t global_columnas[2] = { (size_t)width, (size_t)((height + filas_por_item - 1) / filas_por_item) };
+    return clEnqueueNDRangeKernel(mgr->queue, k_columnas, 2, NULL, global_columnas, NULL, 0, NULL, ev_columnas);
+}
+
+// Costes calibrados por dispositivo (la calibración se hace una vez por proceso).
+// El mutex protege la tabla y se mantiene durante la medida: si dos hilos piden la
+// misma calibración, el segundo espera y reutiliza la del primero
+static struct {
+    cl_device_id dispositivo;
+    CalibracionFFT costes;
+} calibraciones_gpu[MAX_DISPOSITIVOS_CALIBRADOS];
+static int num_calibraciones_gpu = 0;
+static pthread_mutex_t mutex_calibracion = PTHREAD_MUTEX_INITIALIZER;
+
+// Mide conv2d y la cadena FFT sobre una imagen sintética en el dispositivo de mgr
+// (con mutex_calibracion tomado)
+static const CalibracionFFT* calibrar_gpu(CLManager* mgr) {
+    for (int i = 0; i < num_calibraciones_gpu; i++) {
+        if (calibraciones_gpu[i].dispositivo == mgr->device_id) return &calibraciones_gpu[i].costes;
+    }
+    if (num_calibraciones_gpu == MAX_DISPOSITIVOS_CALIBRADOS) return NULL;
+
+    int lado = CALIBRACION_LADO, k = CALIBRACION_K;
+    size_t bytes = (size_t)lado * lado;
+    unsigned char* imagen = (unsigned char*)malloc(bytes);
+    float pesos[CALIBRACION_K * CALIBRACION_K];
+    if (!imagen) return NULL;
+
+    // Imagen y filtro pseudoaleatorios (el filtro no es separable ni de caja)
+    unsigned int semilla = 12345;
+    for (int i = 0; i < lado * lado; i++) {
+        imagen[i] = (unsigned char)aleatorio_siguiente(&semilla);
+    }
+    for (int i = 0; i < k * k; i++) {
+        pesos[i] = (float)(aleatorio_siguiente(&semilla) & 0xFF) / (255.0f * k * k);
+    }
+
+    cl_int err;
+    const CalibracionFFT* resultado = NULL;
+    cl_mem d_in = CLManager_AcquireBuffer(mgr, CL_MEM_READ_ONLY, bytes, &err);
+    cl_mem d_out = CLManager_AcquireBuffer(mgr, CL_MEM_WRITE_ONLY, bytes, &err);
+    cl_mem d_pesos = CLManager_AcquireBuffer(mgr, CL_MEM_READ_ONLY, sizeof(pesos), &err);
+    if (d_in && d_out && d_pesos) {
+        err  = clEnqueueWriteBuffer(mgr->queue, d_in, CL_TRUE, 0, bytes, imagen, 0, NULL, NULL);
+        err |= clEnqueueWriteBuffer(mgr->queue, d_pesos, CL_TRUE, 0, sizeof(pesos), pesos, 0, NULL, NULL);
+    }
+    free(imagen);
+    if (!d_in || !d_out || !d_pesos || err != CL_SUCCESS) goto cleanup;
+
+    double mejor_directo = 1e30, mejor_fft = 1e30;
+    for (int rep = 0; rep < CALIBRACION_REPETICIONES; rep++) {
+        cl_event primero, ultimo;
+        double ms;
+        if (encolar_conv2d(mgr, d_in, d_out, d_pesos, NULL, lado, lado, lado, lado, k, &primero, &ultimo,
+                           NULL) != CL_SUCCESS) {
+            clFinish(mgr->queue);
+            goto cleanup;
+        }
+        clWaitForEvents(1, &ultimo);
+        ms = tiempo_eventos_ms(primero, ultimo);
+        clReleaseEvent(primero);
+        clReleaseEvent(ultimo);
+        if (ms < mejor_directo) mejor_directo = ms;
+
+        if (fft_opencl_convolucionar(mgr, d_in, d_out, lado, lado, pesos, k, &primero, &ultimo) != CL_SUCCESS) {
+            goto cleanup;
+        }
+        clWaitForEvents(1, &ultimo);
+        ms = tiempo_eventos_ms(primero, ultimo);
+        clReleaseEvent(primero);
+        clReleaseEvent(ultimo);
+        if (ms < mejor_fft) mejor_fft = ms;
+    }
+
+    int i = num_calibraciones_gpu++;
+    calibraciones_gpu[i].dispositivo = mgr->device_id;
+    calibraciones_gpu[i].costes.ns_por_tap = mejor_directo * 1e6 / ((double)lado * lado * k * k);
+    calibraciones_gpu[i].costes.ns_por_punto = mejor_fft * 1e6 / fft_coste_puntos(lado, lado, k);
+    resultado = &calibraciones_gpu[i].costes;
+    printf("[Info] Calibracion FFT (GPU): directo %.5f ns/tap, FFT %.4f ns/punto\n",
+           resultado->ns_por_tap, resultado->ns_por_punto);
+
+cleanup:
+    CLManager_ReleaseBuffer(mgr, d_in);
+    CLManager_ReleaseBuffer(mgr, d_out);
+    CLManager_ReleaseBuffer(mgr, d_pesos);
+    return resultado;
+}
+
+static const CalibracionFFT* calibracion_gpu(CLManager* mgr) {
+    pthread_mutex_lock(&mutex_calibracion);
+    const CalibracionFFT* costes = calibrar_gpu(mgr);
+    pthread_mutex_unlock(&mutex_calibracion);
+    return costes;
+}
+
+void convolucion_paralelo_calibrar(CLManager* mgr, int k_size) {
+    if (k_size >= FILTRO_K_MIN_FFT) calibracion_gpu(mgr);
+}
+
+// ============================================
+// Ajuste de work-groups (autotuning) de la convolución directa
+// ============================================
+// Mejor tiempo de kernel de 'repeticiones' lanzamientos (tras uno de calentamiento);
+// < 0 si el lanzamiento falla. Los pesos son sintéticos: solo se especializa -D KSIZE
+static double medir_conv2d_local(CLManager* mgr, const VarianteConv2d* v, const size_t local[2], cl_mem d_in,
+                                 cl_mem d_out, cl_mem d_pesos, int width, int height, int pitch,
+                                 int k_size, int repeticiones) {
+    double mejor = -1.0;
+    for (int rep = -1; rep < repeticiones; rep++) {
+        cl_event primero, ultimo;
+        if (encolar_conv2d_local(mgr, v, local, d_in, d_out, d_pesos, NULL, width, height,
+                                 pitch, pitch, k_size, &primero, &ultimo) != CL_SUCCESS) {
+            clFinish(mgr->queue);
+            return -1.0;
+        }
+        clWaitForEvents(1, &ultimo);
+        double ms = tiempo_eventos_ms(primero, ultimo);
+        clReleaseEvent(primero);
+        clReleaseEvent(ultimo);
+        if (rep >= 0 && (mejor < 0.0 || ms < mejor)) mejor = ms;
+    }
+    return mejor;
+}
+
+int convolucion_paralelo_ajustar(CLManager* mgr, int width, int height, int k_size, int repeticiones) {
+    // Lados candidatos de cada dimensión del work-group (se descartan los que el
+    // dispositivo no admite y los de menos de 16 work-items)
+    static const size_t lados_x[] = { 4, 8, 16, 32, 64, 128, 256 };
+    static const size_t lados_y[] = { 1, 2, 4, 8, 16, 32 };
+
+    int pitch = (int)planar_pitch(width);
+    size_t bytes = (size_t)pitch * height;
+    size_t bytes_filtro = sizeof(float) * k_size * k_size;
+    unsigned char* imagen = (unsigned char*)malloc(bytes);
+    float* pesos = (float*)malloc(bytes_filtro);
+    int ok = 0;
+    cl_int err = CL_SUCCESS;
+    cl_mem d_in = NULL, d_out = NULL, d_pesos = NULL;
+    if (!imagen || !pesos) {
+        printf("Error: Fallo de memoria en el ajuste de work-groups.\n");
+        goto cleanup;
+    }
+
+    // 1. Imagen y filtro pseudoaleatorios (el filtro no es separable ni de caja)
+    unsigned int semilla = 12345;
+    for (size_t i = 0; i < bytes; i++) {
+        imagen[i] = (unsigned char)aleatorio_siguiente(&semilla);
+    }
+    for (int i = 0; i < k_size * k_size; i++) {
+        pesos[i] = (float)(aleatorio_siguiente(&semilla) & 0xFF) / (255.0f * k_size * k_size);
+    }
+
+    d_in = CLManager_AcquireBuffer(mgr, CL_MEM_READ_ONLY, bytes, &err);
+    d_out = CLManager_AcquireBuffer(mgr, CL_MEM_WRITE_ONLY, bytes, &err);
+    d_pesos = CLManager_AcquireBuffer(mgr, CL_MEM_READ_ONLY, bytes_filtro, &err);
+    if (d_in && d_out && d_pesos) {
+        err  = clEnqueueWriteBuffer(mgr->queue, d_in, CL_TRUE, 0, bytes, imagen, 0, NULL, NULL);
+        err |= clEnqueueWriteBuffer(mgr->queue, d_pesos, CL_TRUE, 0, bytes_filtro, pesos, 0, NULL, NULL);
+    }
+    if (!d_in || !d_out || !d_pesos || err != CL_SUCCESS) {
+        printf("Error preparando el ajuste de work-groups (Code %d)\n", err);
+        goto cleanup;
+    }
+
+    printf("[Info] Ajuste de work-groups: imagen %dx%d (clase %d), filtro %dx%d\n",
+           width, height, ajuste_clase(width, height), k_size, k_size);
+
+    // 2. Cada variante (píxeles por work-item incluidos): la referencia (su local sin
+    //    ajuste) y la rejilla de tamaños
+    for (int i_variante = 0; i_variante < NUM_VARIANTES_CONV2D; i_variante++) {
+        const VarianteConv2d* v = &variantes_conv2d[i_variante];
+        cl_kernel kernel = kernel_conv2d(mgr, v, NULL, k_size);
+        if (!kernel) continue;
+
+        size_t mejor_local[2] = { 0, 0 };
+        double mejor_ms = -1.0, referencia_ms = -1.0;
+        if (!v->usar_tiles) {
+            referencia_ms = mejor_ms = medir_conv2d_local(mgr, v, NULL, d_in, d_out, d_pesos,
+                                                          width, height, pitch, k_size, repeticiones);
+        } else {
+            size_t tile[2] = { CONV_TILE, CONV_TILE };
+            if (local_valido(mgr, kernel, tile, bytes_tile(tile, k_size))) {
+                referencia_ms = medir_conv2d_local(mgr, v, tile, d_in, d_out, d_pesos,
+                                                   width, height, pitch, k_size, repeticiones);
+            }
+        }
+
+        for (size_t i = 0; i < sizeof(lados_x) / sizeof(lados_x[0]); i++) {
+            for (size_t j = 0; j < sizeof(lados_y) / sizeof(lados_y[0]); j++) {
+                size_t local[2] = { lados_x[i], lados_y[j] };
+                size_t bytes_local = v->usar_tiles ? bytes_tile(local, k_size) : 0;
+                if (local[0] * local[1] < 16 || !local_valido(mgr, kernel, local, bytes_local)) continue;
+
+                double ms = medir_conv2d_local(mgr, v, local, d_in, d_out, d_pesos,
+                                               width, height, pitch, k_size, repeticiones);
+                if (ms >= 0.0 && (mejor_ms < 0.0 || ms < mejor_ms)) {
+                    mejor_ms = ms;
+                    mejor_local[0] = local[0];
+                    mejor_local[1] = local[1];
+                }
+            }
+        }
+        if (mejor_ms < 0.0) continue;
+
+        // 3. Guardar el ganador ({0, 0} = el local del runtime fue el mejor)
+        ajuste_registrar(mgr->device_id, v->nombre, width, height, k_size, mejor_local, mejor_ms);
+        printf("[Info]   %-15s work-group %zux%zu: %.4f ms", v->nombre, mejor_local[0], mejor_local[1], mejor_ms);
+        if (referencia_ms > 0.0) printf(" (sin ajuste %.4f ms, %.2fx)", referencia_ms, referencia_ms / mejor_ms);
+        printf("\n");
+        ok = 1;
+    }
+
+cleanup:
+    free(imagen);
+    free(pesos);
+    CLManager_ReleaseBuffer(mgr, d_in);
+    CLManager_ReleaseBuffer(mgr, d_out);
+    CLManager_ReleaseBuffer(mgr, d_pesos);
+    return ok;
+}
+
+// ============================================
+// Plan de ejecución: ruta elegida para el filtro y sus buffers auxiliares
+// ============================================
+typedef enum { RUTA_CAJA, RUTA_SEPARABLE, RUTA_FFT, RUTA_DIRECTA } RutaGPU;
+
+typedef struct {
+    RutaGPU ruta;
+    FiltroInfo info;
+    const float* filter;
+    int k_size;
+    cl_mem d_filter;                // Pesos k x k
+    cl_mem d_temp, d_temp2;         // Intermedios de caja (uint) o separable (float)
+    cl_mem d_fila, d_columna;       // Pesos 1D del separable
+} PlanGPU;
+
+// Analiza el filtro, elige la ruta y sube los pesos. Los intermedios del plan se
+// pueden compartir entre imágenes: todo se encola en la misma cola en orden.
+static cl_int plan_preparar(CLManager* mgr, PlanGPU* plan, const float* filter, int k_size, int width, int height) {
+    cl_int err;
+    size_t num_pixels = (size_t)width * height;
+    size_t bytes_filtro = sizeof(float) * k_size * k_size;
+
+    memset(plan, 0, sizeof(*plan));
+    plan->filter = filter;
+    plan->k_size = k_size;
+    filtro_analizar(filter, k_size, &plan->info);
+
+    plan->d_filter = CLManager_AcquireBuffer(mgr, CL_MEM_READ_ONLY, bytes_filtro, &err);
+    if (!plan->d_filter) return err;
+    // Subida no bloqueante: 'filter' es del llamador y vive toda la llamada
+    err = clEnqueueWriteBuffer(mgr->queue, plan->d_filter, CL_FALSE, 0, bytes_filtro, filter, 0, NULL, NULL);
+    if (err != CL_SUCCESS) return err;
+
+    if (filtro_usar_caja(&plan->info)) {
+        plan->ruta = RUTA_CAJA;
+        plan->d_temp = CLManager_AcquireBuffer(mgr, CL_MEM_READ_WRITE, sizeof(cl_uint) * num_pixels, &err);
+        if (plan->d_temp) plan->d_temp2 = CLManager_AcquireBuffer(mgr, CL_MEM_READ_WRITE, sizeof(cl_uint) * num_pixels, &err);
+        return err;
+    }
+
+    if (filtro_usar_separable(&plan->info)) {
+        plan->ruta = RUTA_SEPARABLE;
+        plan->d_temp = CLManager_AcquireBuffer(mgr, CL_MEM_READ_WRITE, sizeof(float) * num_pixels, &err);
+        if (plan->d_temp) plan->d_fila = CLManager_AcquireBuffer(mgr, CL_MEM_READ_ONLY, sizeof(float) * k_size, &err);
+        if (plan->d_fila) plan->d_columna = CLManager_AcquireBuffer(mgr, CL_MEM_READ_ONLY, sizeof(float) * k_size, &err);
+        if (!plan->d_columna) return err;
+
+        // 'info' puede vivir en la pila del llamador: escritura bloqueante (son solo k floats)
+        err  = clEnqueueWriteBuffer(mgr->queue, plan->d_fila, CL_TRUE, 0, sizeof(float) * k_size, plan->info.fila, 0, NULL, NULL);
+        err |= clEnqueueWriteBuffer(mgr->queue, plan->d_columna, CL_TRUE, 0, sizeof(float) * k_size, plan->info.columna, 0, NULL, NULL);
+        return err;
+    }
+
+    // El cruce directo / FFT sale de la calibración del dispositivo
+    if (k_size >= FILTRO_K_MIN_FFT && calibracion_gpu(mgr) &&
+        fft_conviene(calibracion_gpu(mgr), width, height, k_size)) {
+        plan->ruta = RUTA_FFT;
+    } else {
+        plan->ruta = RUTA_DIRECTA;
+    }
+    return CL_SUCCESS;
+}
+
+/**
+ * Encola la convolución d_input -> d_output según el plan, en mgr->queue.
+ * 'pitch' es la distancia entre filas de ambos buffers: solo la ruta directa
+ * admite pitch > width (las demás usan filas contiguas, ver plan_pitch).
+ * En *primero / *ultimo se devuelven el primer y último kernel encolados (para
+ * profiling, en todas las rutas); no espera a que terminen.
+ * En la ruta directa, *conv2d recibe la variante y el work-group lanzados
+ * (variante NULL en las demás rutas).
+ */
+static cl_int plan_encolar(CLManager* mgr, const PlanGPU* plan, cl_mem d_input, cl_mem d_output,
+                           int width, int height, int pitch,
+                           cl_event* primero, cl_event* ultimo, LanzamientoConv2d* conv2d) {
+    int k_size = plan->k_size;
+    cl_int err;
+    *primero = NULL;
+    *ultimo = NULL;
+    conv2d->variante = NULL;
+
+    switch (plan->ruta) {
+    case RUTA_CAJA:
+        // Sumas enteras por scan, O(1) por píxel
+        return encolar_caja(mgr, d_input, d_output, plan->d_temp, plan->d_temp2, width, height, k_size,
+                            plan->info.peso_uniforme, primero, ultimo);
+
+    case RUTA_SEPARABLE: {
+        // Pasada horizontal a d_temp y vertical a d_output.
+        // El orden en la cola garantiza que la vertical ve la horizontal terminada.
+        cl_kernel k_fila = CLManager_GetKernel(mgr, "conv_fila");
+        cl_kernel k_columna = CLManager_GetKernel(mgr, "conv_columna");
+        if (!k_fila || !k_columna) return CL_INVALID_KERNEL_NAME;
+
+        err = encolar_filtro(mgr, k_fila, d_input, plan->d_temp, plan->d_fila, width, height, k_size, primero);
+        if (err != CL_SUCCESS) return err;
+        return encolar_filtro(mgr, k_columna, plan->d_temp, d_output, plan->d_columna, width, height, k_size, ultimo);
+    }
+
+    case RUTA_FFT:
+        return fft_opencl_convolucionar(mgr, d_input, d_output, width, height, plan->filter, k_size, primero, ultimo);
+
+    case RUTA_DIRECTA:
+    default:
+        // conv2d_tiles, conv2d_bloques o conv2d según el dispositivo y el ajuste
+        return encolar_conv2d(mgr, d_input, d_output, plan->d_filter, plan->filter, width, height, pitch, pitch,
+                              k_size, primero, ultimo, conv2d);
+    }
+}
+
+// Pitch de los buffers de imagen en el dispositivo para este plan. Caja, separable y
+// FFT trabajan sobre filas contiguas. La ruta directa alinea cada fila a
+// PLANAR_ALINEACION bytes (lecturas coalescidas) solo si el host ya trae filas con
+// pitch ('con_pitch'): la copia es rectangular de todos modos. Con filas contiguas
+// en el host se mantiene width y la subida y la bajada son copias lineales.
+static int plan_pitch(const PlanGPU* plan, int width, int con_pitch) {
+    return plan->ruta == RUTA_DIRECTA && con_pitch ? (int)planar_pitch(width) : width;
+}
+
+static void plan_liberar(CLManager* mgr, PlanGPU* plan) {
+    CLManager_ReleaseBuffer(mgr, plan->d_temp);
+    CLManager_ReleaseBuffer(mgr, plan->d_temp2);
+    CLManager_ReleaseBuffer(mgr, plan->d_fila);
+    CLManager_ReleaseBuffer(mgr, plan->d_columna);
+    CLManager_ReleaseBuffer(mgr, plan->d_filter);
+}
+
+// Map + unmap bloqueante de un buffer CL_MEM_USE_HOST_PTR: con memoria unificada no
+// copia nada, pero garantiza que host y dispositivo ven los mismos datos
+static cl_int sincronizar_host(CLManager* mgr, cl_mem buffer, cl_map_flags flags, size_t bytes) {
+    cl_int err;
+    void* ptr = clEnqueueMapBuffer(mgr->queue, buffer, CL_TRUE, flags, 0, bytes, 0, NULL, NULL, &err);
+    if (err != CL_SUCCESS) return err;
+    err = clEnqueueUnmapMemObject(mgr->queue, buffer, ptr, 0, NULL, NULL);
+    if (err == CL_SUCCESS) err = clFinish(mgr->queue);
+    return err;
+}
+
+// Subida de un plano del host a un buffer con 'pitch' bytes por fila (no bloqueante).
+// Con los mismos pitch es una escritura normal; si no, WriteBufferRect copia solo
+// los 'width' bytes útiles de cada fila. 'evento' puede ser NULL
+static cl_int subir_plano(CLManager* mgr, cl_mem buffer, size_t pitch, const PlanoImagen* plano, cl_event* evento) {
+    if (plano->pitch == pitch) {
+        size_t bytes = pitch * (plano->height - 1) + plano->width;
+        return clEnqueueWriteBuffer(mgr->queue, buffer, CL_FALSE, 0, bytes, plano->datos, 0, NULL, evento);
+    }
+    size_t origen[3] = { 0, 0, 0 };
+    size_t region[3] = { (size_t)plano->width, (size_t)plano->height, 1 };
+    return clEnqueueWriteBufferRect(mgr->queue, buffer, CL_FALSE, origen, origen, region,
+                                    pitch, 0, plano->pitch, 0, plano->datos, 0, NULL, evento);
+}
+
+// Bajada (bloqueante) de un buffer con 'pitch' bytes por fila a un plano del host.
+// Las columnas de relleno del plano de destino no se tocan
+static cl_int bajar_plano(CLManager* mgr, cl_mem buffer, size_t pitch, const PlanoImagen* plano, cl_event* evento) {
+    if (plano->pitch == pitch) {
+        size_t bytes = pitch * (plano->height - 1) + plano->width;
+        return clEnqueueReadBuffer(mgr->queue, buffer, CL_TRUE, 0, bytes, plano->datos, 0, NULL, evento);
+    }
+    size_t origen[3] = { 0, 0, 0 };
+    size_t region[3] = { (size_t)plano->width, (size_t)plano->height, 1 };
+    return clEnqueueReadBufferRect(mgr->queue, buffer, CL_TRUE, origen, origen, region,
+                                   pitch, 0, plano->pitch, 0, plano->datos, 0, NULL, evento);
+}
+
+void convolucion_paralelo(CLManager* mgr, const unsigned char* input, unsigned char* output,
+                              int width, int height, const float* filter, int k_size, double* kernel_time_ms) {
+    PlanoImagen entrada = { (unsigned char*)input, width, height, (size_t)width };
+    PlanoImagen salida = { output, width, height, (size_t)width };
+    convolucion_paralelo_plano(mgr, &entrada, &salida, filter, k_size, kernel_time_ms);
+}
 
+void convolucion_paralelo_plano(CLManager* mgr, const PlanoImagen* entrada, const PlanoImagen* salida,
+                                const float* filter, int k_size, double* kernel_time_ms) {
+    TiemposGPU tiempos;
+    convolucion_paralelo_fases(mgr, entrada, salida, filter, k_size, &tiempos);
+    *kernel_time_ms = tiempos.kernel_ms;
+}
+
+void convolucion_paralelo_fases(CLManager* mgr, const PlanoImagen* entrada, const PlanoImagen* salida,
+                                const float* filter, int k_size, TiemposGPU* tiempos) {
+
+    cl_int err;
+    cl_event prof_event = NULL;         // Primer kernel encolado
+    cl_event prof_event2 = NULL;        // Último kernel (el mismo en la convolución directa)
+    cl_event ev_subida = NULL, ev_bajada = NULL;
+    int width = entrada->width, height = entrada->height;
+    cl_mem d_input = NULL, d_output = NULL;
+    int entrada_zero_copy = 0, salida_zero_copy = 0;
+    PlanGPU plan;
+    memset(&plan, 0, sizeof(plan));
+    memset(tiempos, 0, sizeof(*tiempos));
+
+    // 1. Elegir algoritmo según el filtro (caja, separable, FFT o directo) y subir pesos
+    // ----------------------------------------------------
+    err = plan_preparar(mgr, &plan, filter, k_size, width, height);
     if (err != CL_SUCCESS) {
-        printf("Error configurando argumentos del kernel.\n");
-        goto cleanup_mem;
+        printf("Error preparando los buffers del filtro (Code %d)\n", err);
+        goto cleanup;
     }
 
-    // 4. Ejecutar Kernel
-    // Definimos cuántos hilos queremos lanzar.
-    // "Para toda la imagen" significa: Un hilo por cada píxel (ancho x alto).
-    size_t global_work_size[2] = { (size_t)width, (size_t)height };
+    // 2. Obtener Buffers en la GPU (del pool del CLManager: entre llamadas con
+    //    el mismo tamaño de imagen no se reserva memoria de dispositivo)
+    // ----------------------------------------------------
+    // Los kernels leen y escriben uchar directamente (convierten a float en
+    // registros y saturan con convert_uchar_sat): 1 byte por píxel en cada sentido.
+    // Si el llamador pasa memoria zero-copy de CLManager_AllocHost con filas
+    // contiguas, los kernels trabajan directamente sobre ella. In situ (entrada y
+    // salida en la misma memoria) solo la entrada es zero-copy: con un único cl_mem
+    // los kernels leerían vecinos que otros work-items ya sobrescribieron
+    size_t bytes_contiguos = (size_t)width * height;
+    int in_situ = (entrada->datos == salida->datos);
+    if (entrada->pitch == (size_t)width) d_input = CLManager_HostBuffer(mgr, entrada->datos, bytes_contiguos);
+    if (salida->pitch == (size_t)width && !in_situ) d_output = CLManager_HostBuffer(mgr, salida->datos, bytes_contiguos);
+    entrada_zero_copy = (d_input != NULL);
+    salida_zero_copy = (d_output != NULL);
+
+    // Un buffer zero-copy fija el pitch del dispositivo al del host
+    int con_pitch = entrada->pitch != (size_t)width || salida->pitch != (size_t)width;
+    size_t pitch = (entrada_zero_copy || salida_zero_copy) ? (size_t)width : (size_t)plan_pitch(&plan, width, con_pitch);
+    size_t img_size_bytes = pitch * height;
 
-    // Esta función es la que menciona tu requisito:
-    err = clEnqueueNDRangeKernel(
-        mgr->queue,       // La cola de comandos
-        mgr->kernel,      // El kernel configurado
-        2,                // Dimensiones (2D: X e Y)
-        NULL,             // Offset global (no usado)
-        global_work_size, // <--- AQUÍ definimos el tamaño total (Width x Height)
-        NULL,             // Local work size (NULL = deja que OpenCL decida)
-        0, NULL,
-        &prof_event     // Eventos (para la semana 3)
-    );
+    if (!d_input) d_input = CLManager_AcquireBuffer(mgr, CL_MEM_READ_ONLY, img_size_bytes, &err);
+    if (!d_output) d_output = CLManager_AcquireBuffer(mgr, CL_MEM_WRITE_ONLY, img_size_bytes, &err);
 
+    if (!d_input || !d_output) {
+        printf("Error creando buffers OpenCL (Code %d)\n", err);
+        goto cleanup; // Salto a limpieza
+    }
+
+    if (entrada_zero_copy) {
+        // Map/unmap: le indica al runtime que el host escribió la memoria (sin copia)
+        err = sincronizar_host(mgr, d_input, CL_MAP_WRITE, img_size_bytes);
+    } else {
+        // Subida no bloqueante: la cola en orden garantiza que los kernels la ven terminada
+        // (si 'input' es memoria pinned, el driver la copia por DMA directamente)
+        err = subir_plano(mgr, d_input, pitch, entrada, &ev_subida);
+    }
+    if (err != CL_SUCCESS) {
+        printf("Error subiendo la imagen (Code %d)\n", err);
+        goto cleanup;
+    }
+
+    LanzamientoConv2d conv2d;
+    err = plan_encolar(mgr, &plan, d_input, d_output, width, height, (int)pitch, &prof_event, &prof_event2, &conv2d);
     if (err != CL_SUCCESS) {
         printf("Error al encolar el kernel (Code %d)\n", err);
-        goto cleanup_mem;
+        goto cleanup;
     }
 
     // Esperar a que termine para poder leer los tiempos
-    clWaitForEvents(1, &prof_event);
+    if (prof_event2) {
+        cl_ulong time_start, time_end;
+        clWaitForEvents(1, &prof_event2);
+        clGetEventProfilingInfo(prof_event, CL_PROFILING_COMMAND_START, sizeof(time_start), &time_start, NULL);
+        clGetEventProfilingInfo(prof_event2, CL_PROFILING_COMMAND_END, sizeof(time_end), &time_end, NULL);
+        tiempos->kernel_ms = (double)(time_end - time_start) / 1000000.0;
+    }
+    if (ev_subida) tiempos->subida_ms = tiempo_evento_ms(ev_subida);
 
-    // --- PROFILING (NUEVO) ---
-    cl_ulong time_start, time_end;
-    clGetEventProfilingInfo(prof_event, CL_PROFILING_COMMAND_START, sizeof(time_start), &time_start, NULL);
-    clGetEventProfilingInfo(prof_event, CL_PROFILING_COMMAND_END, sizeof(time_end), &time_end, NULL);
+    switch (plan.ruta) {
+    case RUTA_CAJA:
+        printf("[Info] Filtro de caja en GPU: %dx%d por sumas prefijas\n", k_size, k_size);
+        break;
+    case RUTA_SEPARABLE:
+        printf("[Info] Filtro separable en GPU: %d + %d taps por pixel\n", k_size, k_size);
+        break;
+    case RUTA_FFT:
+        printf("[Info] Convolucion FFT en GPU: filtro %dx%d\n", k_size, k_size);
+        break;
+    case RUTA_DIRECTA:
+        if (conv2d.variante && conv2d.variante->usar_tiles) {
+            printf("[Info] conv2d por tiles: work-group %zux%zu, tile con halo de %zux%zu en memoria local\n",
+                   conv2d.local[0], conv2d.local[1], conv2d.local[0] + k_size - 1, conv2d.local[1] + k_size - 1);
+        } else if (conv2d.variante && usa_bloques(conv2d.variante)) {
+            printf("[Info] conv2d por bloques: %dx%d pixeles por work-item", conv2d.variante->bloque_x,
+                   conv2d.variante->bloque_y);
+            if (conv2d.local[0]) printf(", work-group %zux%zu", conv2d.local[0], conv2d.local[1]);
+            printf("\n");
+        } else if (conv2d.variante && conv2d.variante->interior_borde) {
+            int half = k_size / 2;
+            printf("[Info] conv2d interior + borde: interior de %dx%d sin clamp y franjas de %d pixeles\n",
+                   width > 2 * half ? width - 2 * half : 0, height > 2 * half ? height - 2 * half : 0, half);
+        }
+        if (pitch != (size_t)width) {
+            printf("[Info] Filas en GPU con pitch de %zu bytes (ancho %d)\n", pitch, width);
+        }
+        break;
+    }
 
-    // Calcular tiempo en nanosegundos y convertir a milisegundos
-    double nanoSeconds = (double)(time_end - time_start);
-    *kernel_time_ms = nanoSeconds / 1000000.0;
-    // -------------------------
     // Esperar a que termine
     clFinish(mgr->queue);
 
-    // 5. Leer Resultados (GPU -> CPU)
+    // 3. Leer Resultados (GPU -> CPU), ya saturados a uchar
     // ----------------------------------------------------
-    err = clEnqueueReadBuffer(mgr->queue, d_output, CL_TRUE, 0, img_size_bytes, host_output_float, 0, NULL, NULL);
+    if (salida_zero_copy) {
+        // Los kernels ya escribieron en 'output': el map solo sincroniza
+        err = sincronizar_host(mgr, d_output, CL_MAP_READ, img_size_bytes);
+    } else {
+        err = bajar_plano(mgr, d_output, pitch, salida, &ev_bajada);
+    }
 
     if (err != CL_SUCCESS) {
         printf("Error leyendo resultados de la GPU.\n");
+    } else if (ev_bajada) {
+        tiempos->bajada_ms = tiempo_evento_ms(ev_bajada);
     }
 
-    // 6. Convertir float de vuelta a unsigned char
-    // ----------------------------------------------------
-    for(size_t i = 0; i < num_pixels; i++) {
-        float val = host_output_float[i];
-        if(val < 0) val = 0;
-        if(val > 255) val = 255;
-        output[i] = (unsigned char)val;
+    // --- Limpieza de recursos locales de esta función ---
+cleanup:
+    // Si se salió por error puede quedar una escritura pendiente desde 'input'
+    if (err != CL_SUCCESS) clFinish(mgr->queue);
+    if(prof_event) clReleaseEvent(prof_event);
+    if(prof_event2) clReleaseEvent(prof_event2);
+    if (ev_subida) clReleaseEvent(ev_subida);
+    if (ev_bajada) clReleaseEvent(ev_bajada);
+    plan_liberar(mgr, &plan);
+    if (!entrada_zero_copy) CLManager_ReleaseBuffer(mgr, d_input);
+    if (!salida_zero_copy) CLManager_ReleaseBuffer(mgr, d_output);
+}
+
+// ============================================
+// Variante con imágenes (image2d_t + sampler con clamp-to-edge)
+// ============================================
+// 1 si el dispositivo admite imágenes 2D CL_R / CL_UNORM_INT8 de width x height con 'flags'
+static int imagen_admitida(CLManager* mgr, cl_mem_flags flags, int width, int height) {
+    cl_bool soporte = CL_FALSE;
+    size_t max_ancho = 0, max_alto = 0;
+    clGetDeviceInfo(mgr->device_id, CL_DEVICE_IMAGE_SUPPORT, sizeof(soporte), &soporte, NULL);
+    clGetDeviceInfo(mgr->device_id, CL_DEVICE_IMAGE2D_MAX_WIDTH, sizeof(max_ancho), &max_ancho, NULL);
+    clGetDeviceInfo(mgr->device_id, CL_DEVICE_IMAGE2D_MAX_HEIGHT, sizeof(max_alto), &max_alto, NULL);
+    if (soporte != CL_TRUE || (size_t)width > max_ancho || (size_t)height > max_alto) return 0;
+
+    cl_image_format formatos[MAX_FORMATOS_IMAGEN];
+    cl_uint num_formatos = 0;
+    if (clGetSupportedImageFormats(mgr->context, flags, CL_MEM_OBJECT_IMAGE2D, MAX_FORMATOS_IMAGEN,
+                                   formatos, &num_formatos) != CL_SUCCESS) {
+        return 0;
+    }
+    for (cl_uint i = 0; i < num_formatos && i < MAX_FORMATOS_IMAGEN; i++) {
+        if (formatos[i].image_channel_order == CL_R && formatos[i].image_channel_data_type == CL_UNORM_INT8) return 1;
     }
+    return 0;
+}
 
-    // --- Limpieza de recursos locales de esta función ---
-cleanup_mem:
-    clReleaseEvent(prof_event);
-    if(d_input) clReleaseMemObject(d_input);
-    if(d_output) clReleaseMemObject(d_output);
-    if(d_filter) clReleaseMemObject(d_filter);
+int convolucion_paralelo_imagen(CLManager* mgr, const PlanoImagen* entrada, const PlanoImagen* salida,
+                                const float* filter, int k_size, TiemposGPU* tiempos) {
+    int width = entrada->width, height = entrada->height;
+    size_t bytes_filtro = sizeof(float) * k_size * k_size;
+    cl_int err = CL_SUCCESS;
+    cl_mem img_entrada = NULL, img_salida = NULL, d_filter = NULL;
+    cl_event ev_subida = NULL, ev_kernel = NULL, ev_bajada = NULL;
+    int ok = 0;
+    memset(tiempos, 0, sizeof(*tiempos));
+
+    // 1. Soporte de imágenes y del formato en este dispositivo
+    if (!imagen_admitida(mgr, CL_MEM_READ_ONLY, width, height) ||
+        !imagen_admitida(mgr, CL_MEM_WRITE_ONLY, width, height)) {
+        printf("Aviso: el dispositivo no admite imagenes CL_R / CL_UNORM_INT8 de %dx%d.\n", width, height);
+        return 0;
+    }
+    cl_kernel kernel = kernel_conv2d(mgr, &variante_imagen, filter, k_size);
+    if (!kernel) return 0;
+
+    // 2. Imágenes de entrada y salida (fuera del pool: sus buffers no sirven como image2d_t)
+    cl_image_format formato = { CL_R, CL_UNORM_INT8 };
+    cl_image_desc descripcion;
+    memset(&descripcion, 0, sizeof(descripcion));
+    descripcion.image_type = CL_MEM_OBJECT_IMAGE2D;
+    descripcion.image_width = (size_t)width;
+    descripcion.image_height = (size_t)height;
+    img_entrada = clCreateImage(mgr->context, CL_MEM_READ_ONLY, &formato, &descripcion, NULL, &err);
+    if (err == CL_SUCCESS) img_salida = clCreateImage(mgr->context, CL_MEM_WRITE_ONLY, &formato, &descripcion, NULL, &err);
+    if (err == CL_SUCCESS) d_filter = CLManager_AcquireBuffer(mgr, CL_MEM_READ_ONLY, bytes_filtro, &err);
+    if (err != CL_SUCCESS) {
+        printf("Error creando las imagenes OpenCL (Code %d)\n", err);
+        goto cleanup;
+    }
+
+    // 3. Subida: el runtime copia las filas del plano (con su pitch) a la imagen
+    size_t origen[3] = { 0, 0, 0 };
+    size_t region[3] = { (size_t)width, (size_t)height, 1 };
+    err  = clEnqueueWriteBuffer(mgr->queue, d_filter, CL_FALSE, 0, bytes_filtro, filter, 0, NULL, NULL);
+    err |= clEnqueueWriteImage(mgr->queue, img_entrada, CL_FALSE, origen, region, entrada->pitch, 0,
+                               entrada->datos, 0, NULL, &ev_subida);
+    if (err != CL_SUCCESS) {
+        printf("Error subiendo la imagen (Code %d)\n", err);
+        goto cleanup;
+    }
+
+    // 4. Un work-item por píxel, sin work-group explícito
+    err  = clSetKernelArg(kernel, 0, sizeof(cl_mem), &img_entrada);
+    err |= clSetKernelArg(kernel, 1, sizeof(cl_mem), &img_salida);
+    err |= clSetKernelArg(kernel, 2, sizeof(cl_mem), &d_filter);
+    err |= clSetKernelArg(kernel, 3, sizeof(int), &k_size);
+    if (err == CL_SUCCESS) {
+        size_t global_work_size[2] = { (size_t)width, (size_t)height };
+        err = clEnqueueNDRangeKernel(mgr->queue, kernel, 2, NULL, global_work_size, NULL, 0, NULL, &ev_kernel);
+    }
+    if (err != CL_SUCCESS) {
+        printf("Error al encolar el kernel (Code %d)\n", err);
+        goto cleanup;
+    }
+
+    // 5. Bajada bloqueante al plano de salida (con su pitch)
+    err = clEnqueueReadImage(mgr->queue, img_salida, CL_TRUE, origen, region, salida->pitch, 0,
+                             salida->datos, 0, NULL, &ev_bajada);
+    if (err != CL_SUCCESS) {
+        printf("Error leyendo la imagen (Code %d)\n", err);
+        goto cleanup;
+    }
+
+    tiempos->subida_ms = tiempo_evento_ms(ev_subida);
+    tiempos->kernel_ms = tiempo_evento_ms(ev_kernel);
+    tiempos->bajada_ms = tiempo_evento_ms(ev_bajada);
+    ok = 1;
 
 cleanup:
-    if(host_input_float) free(host_input_float);
-    if(host_output_float) free(host_output_float);
-}
\ No newline at end of file
+    if (!ok) clFinish(mgr->queue);
+    if (ev_subida) clReleaseEvent(ev_subida);
+    if (ev_kernel) clReleaseEvent(ev_kernel);
+    if (ev_bajada) clReleaseEvent(ev_bajada);
+    if (img_entrada) clReleaseMemObject(img_entrada);
+    if (img_salida) clReleaseMemObject(img_salida);
+    CLManager_ReleaseBuffer(mgr, d_filter);
+    return ok;
+}
+
+void convolucion_paralelo_rgba(CLManager* mgr, const unsigned char* input, unsigned char* output,
+                               int width, int height, const float* filter, int k_size,
+                               int filtrar_alpha, double* kernel_time_ms) {
+    cl_int err = CL_SUCCESS;
+    cl_event prof_event = NULL;
+    size_t img_size_bytes = (size_t)width * height * 4;
+    size_t bytes_filtro = sizeof(float) * k_size * k_size;
+
+    // 1. Buffers (zero-copy si vienen de CLManager_AllocHost)
+    cl_kernel kernel = CLManager_GetKernel(mgr, "conv2d_rgba");
+    cl_mem d_input = CLManager_HostBuffer(mgr, input, img_size_bytes);
+    cl_mem d_output = CLManager_HostBuffer(mgr, output, img_size_bytes);
+    int entrada_zero_copy = (d_input != NULL);
+    int salida_zero_copy = (d_output != NULL);
+
+    if (!d_input) d_input = CLManager_AcquireBuffer(mgr, CL_MEM_READ_ONLY, img_size_bytes, &err);
+    if (!d_output) d_output = CLManager_AcquireBuffer(mgr, CL_MEM_WRITE_ONLY, img_size_bytes, &err);
+    cl_mem d_filter = CLManager_AcquireBuffer(mgr, CL_MEM_READ_ONLY, bytes_filtro, &err);
+
+    if (!kernel || !d_input || !d_output || !d_filter) {
+        printf("Error preparando la convolucion RGBA (Code %d)\n", err);
+        if (err == CL_SUCCESS) err = CL_INVALID_KERNEL_NAME;
+        goto cleanup;
+    }
+
+    if (entrada_zero_copy) {
+        err = sincronizar_host(mgr, d_input, CL_MAP_WRITE, img_size_bytes);
+    } else {
+        err = clEnqueueWriteBuffer(mgr->queue, d_input, CL_FALSE, 0, img_size_bytes, input, 0, NULL, NULL);
+    }
+    if (err == CL_SUCCESS) {
+        err = clEnqueueWriteBuffer(mgr->queue, d_filter, CL_FALSE, 0, bytes_filtro, filter, 0, NULL, NULL);
+    }
+
+    // 2. Un work-item por píxel, los 4 canales a la vez
+    if (err == CL_SUCCESS) {
+        err  = clSetKernelArg(kernel, 0, sizeof(cl_mem), &d_input);
+        err |= clSetKernelArg(kernel, 1, sizeof(cl_mem), &d_output);
+        err |= clSetKernelArg(kernel, 2, sizeof(cl_mem), &d_filter);
+        err |= clSetKernelArg(kernel, 3, sizeof(int), &width);
+        err |= clSetKernelArg(kernel, 4, sizeof(int), &height);
+        err |= clSetKernelArg(kernel, 5, sizeof(int), &k_size);
+        err |= clSetKernelArg(kernel, 6, sizeof(int), &filtrar_alpha);
+    }
+    if (err == CL_SUCCESS) {
+        size_t global_work_size[2] = { (size_t)width, (size_t)height };
+        err = clEnqueueNDRangeKernel(mgr->queue, kernel, 2, NULL, global_work_size, NULL, 0, NULL, &prof_event);
+    }
+    if (err != CL_SUCCESS) {
+        printf("Error al encolar conv2d_rgba (Code %d)\n", err);
+        goto cleanup;
+    }
+
+    clWaitForEvents(1, &prof_event);
+    *kernel_time_ms = tiempo_evento_ms(prof_event);
+    printf("[Info] Convolucion RGBA en GPU: filtro %dx%d, alfa %s\n", k_size, k_size,
+           filtrar_alpha ? "filtrado" : "sin filtrar");
+
+    // 3. Resultado al host
+    if (salida_zero_copy) {
+        err = sincronizar_host(mgr, d_output, CL_MAP_READ, img_size_bytes);
+    } else {
+        err = clEnqueueReadBuffer(mgr->queue, d_output, CL_TRUE, 0, img_size_bytes, output, 0, NULL, NULL);
+    }
+    if (err != CL_SUCCESS) {
+        printf("Error leyendo resultados de la GPU.\n");
+    }
+
+cleanup:
+    if (err != CL_SUCCESS) clFinish(mgr->queue);
+    if (prof_event) clReleaseEvent(prof_event);
+    if (!entrada_zero_copy) CLManager_ReleaseBuffer(mgr, d_input);
+    if (!salida_zero_copy) CLManager_ReleaseBuffer(mgr, d_output);
+    CLManager_ReleaseBuffer(mgr, d_filter);
+}
+
+void convolucion_paralelo_roi(CLManager* mgr, const PlanoImagen* entrada, const PlanoImagen* salida,
+                              const float* filter, int k_size, const RegionROI* regiones, int num_regiones,
+                              double* kernel_time_ms) {
+    cl_int err = CL_SUCCESS;
+    int width = entrada->width, height = entrada->height;
+    int half = k_size / 2;
+    size_t img_size_bytes = (size_t)width * height;
+    size_t bytes_filtro = sizeof(float) * k_size * k_size;
+    size_t bytes_subidos = 0;
+    int num_validas = 0;
+    *kernel_time_ms = 0.0;
+
+    // 1. Buffers del tamaño de la imagen completa (pitch = width): cada región y su
+    //    halo ocupan en el dispositivo la misma posición que en el host, así conv2d
+    //    hace el clamp contra los bordes de la imagen sin saber nada de las regiones
+    RegionROI* recortadas = (RegionROI*)malloc(sizeof(RegionROI) * (num_regiones > 0 ? num_regiones : 1));
+    cl_event* eventos = (cl_event*)calloc(num_regiones > 0 ? num_regiones : 1, sizeof(cl_event));
+    cl_mem d_input = CLManager_AcquireBuffer(mgr, CL_MEM_READ_ONLY, img_size_bytes, &err);
+    cl_mem d_output = CLManager_AcquireBuffer(mgr, CL_MEM_WRITE_ONLY, img_size_bytes, &err);
+    cl_mem d_filter = CLManager_AcquireBuffer(mgr, CL_MEM_READ_ONLY, bytes_filtro, &err);
+
+    if (!recortadas || !eventos || !d_input || !d_output || !d_filter) {
+        printf("Error preparando la convolucion por regiones (Code %d)\n", err);
+        if (err == CL_SUCCESS) err = CL_OUT_OF_HOST_MEMORY;
+        goto cleanup;
+    }
+    err = clEnqueueWriteBuffer(mgr->queue, d_filter, CL_FALSE, 0, bytes_filtro, filter, 0, NULL, NULL);
+
+    // 2. Subir solo el halo de cada región (región + k_size / 2 por lado, recortado a la imagen)
+    for (int i = 0; i < num_regiones && err == CL_SUCCESS; i++) {
+        RegionROI halo;
+        if (!roi_recortar(&regiones[i], width, height, &recortadas[num_validas])) continue;
+
+        RegionROI ampliada = recortadas[num_validas];
+        ampliada.x -= half;
+        ampliada.y -= half;
+        ampliada.width += 2 * half;
+        ampliada.height += 2 * half;
+        roi_recortar(&ampliada, width, height, &halo);
+        num_validas++;
+
+        size_t origen[3] = { (size_t)halo.x, (size_t)halo.y, 0 };
+        size_t region[3] = { (size_t)halo.width, (size_t)halo.height, 1 };
+        err = clEnqueueWriteBufferRect(mgr->queue, d_input, CL_FALSE, origen, origen, region,
+                                       (size_t)width, 0, entrada->pitch, 0, entrada->datos, 0, NULL, NULL);
+        bytes_subidos += (size_t)halo.width * halo.height;
+    }
+
+    // 3. Un NDRange con offset por región. Las bajadas van después de todos los
+    //    kernels y las subidas antes: entrada y salida pueden ser la misma imagen
+    for (int i = 0; i < num_validas && err == CL_SUCCESS; i++) {
+        err = encolar_conv2d_region(mgr, d_input, d_output, d_filter, filter, width, height, width, width, k_size,
+                                    &recortadas[i], &eventos[i]);
+    }
+    for (int i = 0; i < num_validas && err == CL_SUCCESS; i++) {
+        size_t origen[3] = { (size_t)recortadas[i].x, (size_t)recortadas[i].y, 0 };
+        size_t region[3] = { (size_t)recortadas[i].width, (size_t)recortadas[i].height, 1 };
+        err = clEnqueueReadBufferRect(mgr->queue, d_output, CL_FALSE, origen, origen, region,
+                                      (size_t)width, 0, salida->pitch, 0, salida->datos, 0, NULL, NULL);
+    }
+    if (err != CL_SUCCESS) {
+        printf("Error al encolar la convolucion por regiones (Code %d)\n", err);
+        goto cleanup;
+    }
+
+    err = clFinish(mgr->queue);
+    for (int i = 0; i < num_validas; i++) *kernel_time_ms += tiempo_evento_ms(eventos[i]);
+    printf("[Info] ROI en GPU: %d regiones, %zu bytes subidos (%.1f%% de la imagen)\n",
+           num_validas, bytes_subidos, 100.0 * bytes_subidos / (double)img_size_bytes);
+
+cleanup:
+    if (err != CL_SUCCESS) clFinish(mgr->queue);
+    if (eventos) {
+        for (int i = 0; i < num_regiones; i++) {
+            if (eventos[i]) clReleaseEvent(eventos[i]);
+        }
+    }
+    free(eventos);
+    free(recortadas);
+    CLManager_ReleaseBuffer(mgr, d_input);
+    CLManager_ReleaseBuffer(mgr, d_output);
+    CLManager_ReleaseBuffer(mgr, d_filter);
+}
+
+// ============================================
+// Secuencias de imágenes: subida / cómputo / bajada solapadas
+// ============================================
+// Tiempo entre dos instantes de profiling (ms)
+static double intervalo_ms(cl_event desde, cl_profiling_info info_desde, cl_event hasta, cl_profiling_info info_hasta,
+                           cl_ulong* inicio, cl_ulong* fin) {
+    cl_ulong t0, t1;
+    clGetEventProfilingInfo(desde, info_desde, sizeof(t0), &t0, NULL);
+    clGetEventProfilingInfo(hasta, info_hasta, sizeof(t1), &t1, NULL);
+    if (t0 < *inicio) *inicio = t0;
+    if (t1 > *fin) *fin = t1;
+    return t1 > t0 ? (double)(t1 - t0) / 1000000.0 : 0.0;
+}
+
+int convolucion_paralelo_secuencia(CLManager* mgr, const unsigned char* const* entradas, unsigned char* const* salidas,
+                                   int num_frames, int width, int height, const float* filter, int k_size,
+                                   int en_vuelo, EstadisticasSecuencia* stats) {
+    cl_int err = CL_SUCCESS;
+    size_t bytes = (size_t)width * height;
+    int ok = 0;
+
+    if (num_frames <= 0) return 1;
+    if (en_vuelo < 2) en_vuelo = 2;
+    if (en_vuelo > SECUENCIA_MAX_EN_VUELO) en_vuelo = SECUENCIA_MAX_EN_VUELO;
+
+    // 1. Una cola por fase: el cómputo va en mgr->queue (ahí encolan todas las rutas)
+    //    y subidas y bajadas en colas propias para que el DMA corra en paralelo
+    cl_command_queue q_subida = clCreateCommandQueue(mgr->context, mgr->device_id, CL_QUEUE_PROFILING_ENABLE, &err);
+    cl_command_queue q_bajada = clCreateCommandQueue(mgr->context, mgr->device_id, CL_QUEUE_PROFILING_ENABLE, &err);
+
+    // Eventos de cada frame: subida, inicio del cómputo (barrera), fin del cómputo (marcador), bajada
+    cl_event* eventos = (cl_event*)calloc((size_t)num_frames * 4, sizeof(cl_event));
+    cl_event* ev_subida = eventos;
+    cl_event* ev_inicio = eventos + num_frames;
+    cl_event* ev_computo = eventos + 2 * num_frames;
+    cl_event* ev_bajada = eventos + 3 * num_frames;
+
+    // Un par entrada/salida por frame en vuelo; los intermedios del plan se comparten
+    cl_mem d_in[SECUENCIA_MAX_EN_VUELO] = { NULL };
+    cl_mem d_out[SECUENCIA_MAX_EN_VUELO] = { NULL };
+    PlanGPU plan;
+    memset(&plan, 0, sizeof(plan));
+
+    if (!q_subida || !q_bajada || !eventos) {
+        printf("Error creando las colas del pipeline (Code %d)\n", err);
+        goto cleanup;
+    }
+    for (int s = 0; s < en_vuelo; s++) {
+        d_in[s] = CLManager_AcquireBuffer(mgr, CL_MEM_READ_ONLY, bytes, &err);
+        d_out[s] = CLManager_AcquireBuffer(mgr, CL_MEM_WRITE_ONLY, bytes, &err);
+        if (!d_in[s] || !d_out[s]) {
+            printf("Error creando buffers OpenCL (Code %d)\n", err);
+            goto cleanup;
+        }
+    }
+
+    err = plan_preparar(mgr, &plan, filter, k_size, width, height);
+    if (err != CL_SUCCESS) {
+        printf("Error preparando los buffers del filtro (Code %d)\n", err);
+        goto cleanup;
+    }
+
+    // 2. Frame i en la ranura s = i % en_vuelo. Dependencias (todas por eventos):
+    //    subida(i)  espera al cómputo de i - en_vuelo (que leía d_in[s])
+    //    cómputo(i) espera a subida(i) y a la bajada de i - en_vuelo (que leía d_out[s])
+    //    bajada(i)  espera al cómputo(i)
+    //    Así la subida de i+1 y la bajada de i-1 corren mientras se calcula i.
+    for (int i = 0; i < num_frames; i++) {
+        int s = i % en_vuelo;
+        int previo = i - en_vuelo;
+
+        err = clEnqueueWriteBuffer(q_subida, d_in[s], CL_FALSE, 0, bytes, entradas[i],
+                                   previo >= 0 ? 1 : 0, previo >= 0 ? &ev_computo[previo] : NULL, &ev_subida[i]);
+        if (err != CL_SUCCESS) break;
+        clFlush(q_subida);
+
+        cl_event espera[2] = { ev_subida[i], previo >= 0 ? ev_bajada[previo] : NULL };
+        err = clEnqueueBarrierWithWaitList(mgr->queue, previo >= 0 ? 2 : 1, espera, &ev_inicio[i]);
+        if (err != CL_SUCCESS) break;
+
+        cl_event primero, ultimo;
+        LanzamientoConv2d conv2d;
+        err = plan_encolar(mgr, &plan, d_in[s], d_out[s], width, height, width, &primero, &ultimo, &conv2d);
+        if (primero) clReleaseEvent(primero);
+        if (ultimo) clReleaseEvent(ultimo);
+        if (err != CL_SUCCESS) break;
+
+        // El marcador termina cuando termina todo lo anterior en la cola (vale para cualquier ruta)
+        err = clEnqueueMarkerWithWaitList(mgr->queue, 0, NULL, &ev_computo[i]);
+        if (err != CL_SUCCESS) break;
+        clFlush(mgr->queue);
+
+        err = clEnqueueReadBuffer(q_bajada, d_out[s], CL_FALSE, 0, bytes, salidas[i], 1, &ev_computo[i], &ev_bajada[i]);
+        if (err != CL_SUCCESS) break;
+        clFlush(q_bajada);
+    }
+
+    clFinish(q_subida);
+    clFinish(mgr->queue);
+    clFinish(q_bajada);
+
+    if (err != CL_SUCCESS) {
+        printf("Error en el pipeline de la secuencia (Code %d)\n", err);
+        goto cleanup;
+    }
+
+    // 3. Solapamiento: tiempo en serie (suma de fases) vs. tiempo real de la secuencia
+    EstadisticasSecuencia est;
+    memset(&est, 0, sizeof(est));
+    cl_ulong inicio = (cl_ulong)-1, fin = 0;
+    for (int i = 0; i < num_frames; i++) {
+        est.subida_ms += intervalo_ms(ev_subida[i], CL_PROFILING_COMMAND_START, ev_subida[i], CL_PROFILING_COMMAND_END, &inicio, &fin);
+        est.computo_ms += intervalo_ms(ev_inicio[i], CL_PROFILING_COMMAND_END, ev_computo[i], CL_PROFILING_COMMAND_END, &inicio, &fin);
+        est.bajada_ms += intervalo_ms(ev_bajada[i], CL_PROFILING_COMMAND_START, ev_bajada[i], CL_PROFILING_COMMAND_END, &inicio, &fin);
+    }
+    est.frames = num_frames;
+    est.en_vuelo = en_vuelo;
+    est.total_ms = fin > inicio ? (double)(fin - inicio) / 1000000.0 : 0.0;
+    double serie_ms = est.subida_ms + est.computo_ms + est.bajada_ms;
+    est.solapamiento = serie_ms > 0.0 ? 1.0 - est.total_ms / serie_ms : 0.0;
+    if (est.solapamiento < 0.0) est.solapamiento = 0.0;
+
+    printf("[Info] Pipeline: %d frames, %d en vuelo | subida %.3f ms, computo %.3f ms, bajada %.3f ms "
+           "(en serie %.3f ms) | total %.3f ms, solapamiento %.1f%%\n",
+           est.frames, est.en_vuelo, est.subida_ms, est.computo_ms, est.bajada_ms, serie_ms,
+           est.total_ms, 100.0 * est.solapamiento);
+    if (stats) *stats = est;
+    ok = 1;
+
+cleanup:
+    if (eventos) {
+        for (int i = 0; i < num_frames * 4; i++) {
+            if (eventos[i]) clReleaseEvent(eventos[i]);
+        }
+        free(eventos);
+    }
+    plan_liberar(mgr, &plan);
+    for (int s = 0; s < en_vuelo; s++) {
+        CLManager_ReleaseBuffer(mgr, d_in[s]);
+        CLManager_ReleaseBuffer(mgr, d_out[s]);
+    }
+    if (q_subida) clReleaseCommandQueue(q_subida);
+    if (q_bajada) clReleaseCommandQueue(q_bajada);
+    return ok;
+}
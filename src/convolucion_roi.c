@@ -0,0 +1,94 @@
+#include "convolucion_roi.h"
+#include "convolucion_simd.h"
+#include "pool_hilos.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+// Filas por tarea: las regiones pequeñas son una sola tarea, las grandes se reparten
+#define FILAS_POR_BANDA 16
+
+typedef struct {
+    const PlanoImagen* entrada;
+    const PlanoImagen* salida;
+    const float* kernel;
+    int k_size;
+    RegionROI* regiones;        // Ya recortadas a la imagen
+    int* primera_banda;         // Índice de la primera banda de cada región (+ total al final)
+    int num_regiones;
+} TrabajoROI;
+
+int roi_recortar(const RegionROI* region, int width, int height, RegionROI* recortada) {
+    int x0 = region->x < 0 ? 0 : region->x;
+    int y0 = region->y < 0 ? 0 : region->y;
+    int x1 = region->x + region->width > width ? width : region->x + region->width;
+    int y1 = region->y + region->height > height ? height : region->y + region->height;
+    if (x1 <= x0 || y1 <= y0) return 0;
+
+    recortada->x = x0;
+    recortada->y = y0;
+    recortada->width = x1 - x0;
+    recortada->height = y1 - y0;
+    return 1;
+}
+
+static void procesar_banda(void* contexto, int banda) {
+    TrabajoROI* t = (TrabajoROI*)contexto;
+
+    // Región a la que pertenece la banda (pocas regiones: búsqueda lineal)
+    int r = 0;
+    while (banda >= t->primera_banda[r + 1]) r++;
+    const RegionROI* region = &t->regiones[r];
+
+    int y_ini = region->y + (banda - t->primera_banda[r]) * FILAS_POR_BANDA;
+    int y_fin = y_ini + FILAS_POR_BANDA;
+    if (y_fin > region->y + region->height) y_fin = region->y + region->height;
+
+    convolucion_simd_plano_bloque(t->entrada, t->salida, t->kernel, t->k_size,
+                                  region->x, region->x + region->width, y_ini, y_fin);
+}
+
+void convolucion_roi(const PlanoImagen* entrada, const PlanoImagen* salida,
+                     const float* kernel, int k_size, const RegionROI* regiones, int num_regiones) {
+    TrabajoROI trabajo = {
+        .entrada = entrada,
+        .salida = salida,
+        .kernel = kernel,
+        .k_size = k_size,
+    };
+
+    // 1. Recortar regiones y numerar sus bandas
+    trabajo.regiones = (RegionROI*)malloc(sizeof(RegionROI) * (num_regiones > 0 ? num_regiones : 1));
+    trabajo.primera_banda = (int*)malloc(sizeof(int) * (num_regiones + 1));
+    if (!trabajo.regiones || !trabajo.primera_banda) {
+        printf("Error: No hay memoria para las regiones de interes.\n");
+        goto cleanup;
+    }
+
+    long long pixeles = 0;
+    int num_bandas = 0;
+    for (int i = 0; i < num_regiones; i++) {
+        RegionROI* region = &trabajo.regiones[trabajo.num_regiones];
+        if (!roi_recortar(&regiones[i], entrada->width, entrada->height, region)) continue;
+
+        trabajo.primera_banda[trabajo.num_regiones++] = num_bandas;
+        num_bandas += (region->height + FILAS_POR_BANDA - 1) / FILAS_POR_BANDA;
+        pixeles += (long long)region->width * region->height;
+    }
+    trabajo.primera_banda[trabajo.num_regiones] = num_bandas;
+
+    // 2. Bandas de todas las regiones en el pool (o en este hilo)
+    PoolHilos* pool = pool_global();
+    if (pool) {
+        pool_ejecutar(pool, num_bandas, procesar_banda, &trabajo);
+    } else {
+        for (int b = 0; b < num_bandas; b++) procesar_banda(&trabajo, b);
+    }
+
+    printf("[Info] ROI en CPU: %d regiones, %lld pixeles (%.1f%% de la imagen)\n", trabajo.num_regiones, pixeles,
+           100.0 * pixeles / ((double)entrada->width * entrada->height));
+
+cleanup:
+    free(trabajo.regiones);
+    free(trabajo.primera_banda);
+}
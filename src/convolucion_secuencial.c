@@ -1,78 +1,242 @@
 #include "convolucion_secuencial.h"
+#include "progreso.h"
 
 #include <stdio.h>
 
-// Variable estática
-static int ultimo_porcentaje = -1;
+// Ancho de los bloques del kernel interior: el acumulador (1 KB) vive en L1
+#define BLOQUE_X 256
 
+// Interior con pitch de entrada y salida (despacho por k_size, ver más abajo)
+static void interior_despachar(const unsigned char* input, size_t pitch_in, unsigned char* output, size_t pitch_out,
+                               const float* kernel, int k_size, int y, int x_ini, int x_fin);
 
 void convolucion_secuencial(const unsigned char* input, unsigned char* output,
                             int width, int height, const float* kernel, int k_size) {
 
-    int half = k_size / 2;
-    long long total_ops = 0; // Contador para estadística
+    Progreso prog;
+    progreso_iniciar(&prog, height);
 
-    // Iterar sobre cada pixel de la imagen (Filas y Columnas)
+    // Iterar sobre las filas de la imagen (interior + bordes)
     for (int y = 0; y < height; y++) {
+        convolucion_secuencial_filas(input, output, width, height, kernel, k_size, y, y + 1);
         //--- PORCENTAJE DE PROGRESO
-        progreso(y, height);
+        progreso_avanzar(&prog, 1);
         //------------------------------
-        for (int x = 0; x < width; x++) {
+    }
+    progreso_finalizar(&prog);
+
+    long long total_ops = (long long)width * height * k_size * k_size; // Contador para estadística
+    printf("[Info] Operaciones Totales: %lld\n", total_ops);
+}
 
-            float sum = 0.0f;
+void convolucion_secuencial_filas(const unsigned char* input, unsigned char* output,
+                                  int width, int height, const float* kernel, int k_size,
+                                  int y_ini, int y_fin) {
+    PlanoImagen entrada = { (unsigned char*)input, width, height, (size_t)width };
+    PlanoImagen salida = { output, width, height, (size_t)width };
+    convolucion_secuencial_plano_filas(&entrada, &salida, kernel, k_size, y_ini, y_fin);
+}
 
-            // Convolución: Recorrer la máscara/kernel sobre el pixel actual
-            for (int ky = -half; ky <= half; ky++) {
-                for (int kx = -half; kx <= half; kx++) {
+void convolucion_secuencial_plano(const PlanoImagen* entrada, const PlanoImagen* salida,
+                                  const float* kernel, int k_size) {
+    convolucion_secuencial_plano_filas(entrada, salida, kernel, k_size, 0, entrada->height);
+}
 
-                    // Calcular coordenada del pixel vecino
-                    int ix = x + kx;
-                    int iy = y + ky;
+void convolucion_secuencial_plano_filas(const PlanoImagen* entrada, const PlanoImagen* salida,
+                                        const float* kernel, int k_size, int y_ini, int y_fin) {
+    int width = entrada->width, height = entrada->height;
+    int half = k_size / 2;
 
-                    // Manejo de bordes (Clamp) - Igual que en el Kernel GPU
-                    if(ix < 0) ix = 0;
-                    if(ix >= width) ix = width - 1;
-                    if(iy < 0) iy = 0;
-                    if(iy >= height) iy = height - 1;
+    // Rectángulo interior: la ventana completa cae dentro de la imagen
+    int x_ini = half, x_fin = width - half;
+    int y_int_ini = half, y_int_fin = height - half;
 
-                    // Obtener valor del píxel (0-255) y peso del kernel
-                    // Convertimos a float para operar con precisión
-                    float pixel_val = (float)input[iy * width + ix];
-                    float weight = kernel[(ky + half) * k_size + (kx + half)];
+    for (int y = y_ini; y < y_fin; y++) {
+        unsigned char* out = salida->datos + (size_t)y * salida->pitch;
 
-                    sum += pixel_val * weight;
-                    total_ops++;
-                }
+        if (y < y_int_ini || y >= y_int_fin || x_ini >= x_fin) {
+            // Fila de borde: todos los píxeles con clamp
+            for (int x = 0; x < width; x++) {
+                out[x] = convolucion_pixel_plano(entrada, kernel, k_size, x, y);
             }
+            continue;
+        }
+
+        // Columnas de borde izquierda y derecha (clamp), interior sin ramas
+        for (int x = 0; x < x_ini; x++) {
+            out[x] = convolucion_pixel_plano(entrada, kernel, k_size, x, y);
+        }
+        interior_despachar(entrada->datos, entrada->pitch, salida->datos, salida->pitch,
+                           kernel, k_size, y, x_ini, x_fin);
+        for (int x = x_fin; x < width; x++) {
+            out[x] = convolucion_pixel_plano(entrada, kernel, k_size, x, y);
+        }
+    }
+}
+
+// Kernel interior genérico (cualquier k_size)
+static void interior_generico(const unsigned char* input, size_t pitch_in, unsigned char* output, size_t pitch_out,
+                              const float* kernel, int k_size, int y, int x_ini, int x_fin) {
+    int half = k_size / 2;
+    float acc[BLOQUE_X];
+
+    for (int x0 = x_ini; x0 < x_fin; x0 += BLOQUE_X) {
+        int n = x_fin - x0 < BLOQUE_X ? x_fin - x0 : BLOQUE_X;
+
+        for (int i = 0; i < n; i++) acc[i] = 0.0f;
+
+        // Recorremos el filtro por fuera y los píxeles por dentro: cada acc[i]
+        // recibe las mismas sumas en el mismo orden (ky, kx) que convolucion_pixel(),
+        // y el bucle interno (sin ramas ni dependencias entre i) se autovectoriza.
+        for (int ky = 0; ky < k_size; ky++) {
+            const unsigned char* fila = input + (size_t)(y - half + ky) * pitch_in + (x0 - half);
+            const float* pesos = kernel + ky * k_size;
 
-            // "Clamp" del resultado final para que encaje en un byte (0-255)
-            if (sum < 0) sum = 0;
-            if (sum > 255) sum = 255;
+            for (int kx = 0; kx < k_size; kx++) {
+                const unsigned char* p = fila + kx;
+                float weight = pesos[kx];
+                for (int i = 0; i < n; i++) {
+                    acc[i] += (float)p[i] * weight;
+                }
+            }
+        }
 
-            output[y * width + x] = (unsigned char)sum;
+        // "Clamp" del resultado final para que encaje en un byte (0-255)
+        unsigned char* out = output + (size_t)y * pitch_out + x0;
+        for (int i = 0; i < n; i++) {
+            float sum = acc[i];
+            sum = sum < 0.0f ? 0.0f : sum;
+            sum = sum > 255.0f ? 255.0f : sum;
+            out[i] = (unsigned char)sum;
         }
     }
-    // 3. Cierre estético
-    // Si el último no fue 100 (por redondeo), lo ponemos para cerrar bien
-    if (ultimo_porcentaje != 100) {
-        printf("100%%");
+}
+
+// ============================================
+// Kernels interiores especializados (3x3, 5x5, 7x7, 9x9)
+// ============================================
+// Con k_size constante los bucles de la ventana se despliegan por completo (macros)
+// y los pesos se copian una vez a variables locales, que el compilador mantiene en
+// registros (o como vectores de difusión al vectorizar el bucle en x). Además las
+// filas de la ventana se convierten a float una sola vez por bloque, no una vez por tap.
+// El orden de las sumas es (ky, kx) como en convolucion_pixel(): mismos resultados.
+
+#define TAP(ky, kx) sum += filas[ky][i + (kx)] * w[(ky) * LADO + (kx)];
+
+#define TAPS_3(ky) TAP(ky, 0) TAP(ky, 1) TAP(ky, 2)
+#define TAPS_5(ky) TAPS_3(ky) TAP(ky, 3) TAP(ky, 4)
+#define TAPS_7(ky) TAPS_5(ky) TAP(ky, 5) TAP(ky, 6)
+#define TAPS_9(ky) TAPS_7(ky) TAP(ky, 7) TAP(ky, 8)
+
+#define FILAS_3(T) T(0) T(1) T(2)
+#define FILAS_5(T) FILAS_3(T) T(3) T(4)
+#define FILAS_7(T) FILAS_5(T) T(5) T(6)
+#define FILAS_9(T) FILAS_7(T) T(7) T(8)
+
+#define DEFINIR_INTERIOR(K)                                                              \
+static void interior_##K##x##K(const unsigned char* input, size_t pitch_in,              \
+                               unsigned char* output, size_t pitch_out,                  \
+                               const float* kernel, int k_size,                          \
+                               int y, int x_ini, int x_fin) {                            \
+    enum { LADO = K };                                                                   \
+    (void)k_size;                                                                        \
+    float w[LADO * LADO];                                                                \
+    for (int i = 0; i < LADO * LADO; i++) w[i] = kernel[i];                              \
+                                                                                         \
+    /* Filas de la ventana ya convertidas a float (una conversión por píxel y fila) */   \
+    float filas[LADO][BLOQUE_X + LADO - 1];                                              \
+    unsigned char* out = output + (size_t)y * pitch_out;                                 \
+                                                                                         \
+    for (int x0 = x_ini; x0 < x_fin; x0 += BLOQUE_X) {                                   \
+        int n = x_fin - x0 < BLOQUE_X ? x_fin - x0 : BLOQUE_X;                           \
+                                                                                         \
+        for (int ky = 0; ky < LADO; ky++) {                                              \
+            const unsigned char* src = input + (size_t)(y - LADO / 2 + ky) * pitch_in    \
+                                             + (x0 - LADO / 2);                          \
+            for (int i = 0; i < n + LADO - 1; i++) filas[ky][i] = (float)src[i];         \
+        }                                                                                \
+                                                                                         \
+        for (int i = 0; i < n; i++) {                                                    \
+            float sum = 0.0f;                                                            \
+            FILAS_##K(TAPS_##K)                                                          \
+            sum = sum < 0.0f ? 0.0f : sum;                                               \
+            sum = sum > 255.0f ? 255.0f : sum;                                           \
+            out[x0 + i] = (unsigned char)sum;                                            \
+        }                                                                                \
+    }                                                                                    \
+}
+
+DEFINIR_INTERIOR(3)
+DEFINIR_INTERIOR(5)
+DEFINIR_INTERIOR(7)
+DEFINIR_INTERIOR(9)
+
+typedef void (*KernelInterior)(const unsigned char* input, size_t pitch_in, unsigned char* output, size_t pitch_out,
+                               const float* kernel, int k_size, int y, int x_ini, int x_fin);
+
+// Tabla de despacho por k_size (NULL = usar el genérico)
+#define K_ESPECIALIZADO_MAX 9
+static const KernelInterior kernels_interiores[K_ESPECIALIZADO_MAX + 1] = {
+    [3] = interior_3x3,
+    [5] = interior_5x5,
+    [7] = interior_7x7,
+    [9] = interior_9x9,
+};
+
+static void interior_despachar(const unsigned char* input, size_t pitch_in, unsigned char* output, size_t pitch_out,
+                               const float* kernel, int k_size, int y, int x_ini, int x_fin) {
+    KernelInterior especializado = NULL;
+    if (k_size >= 0 && k_size <= K_ESPECIALIZADO_MAX) especializado = kernels_interiores[k_size];
+
+    if (especializado) {
+        especializado(input, pitch_in, output, pitch_out, kernel, k_size, y, x_ini, x_fin);
+    } else {
+        interior_generico(input, pitch_in, output, pitch_out, kernel, k_size, y, x_ini, x_fin);
     }
-    printf("\n"); // Ahora sí, salto de línea final
+}
 
-    printf("[Info] Operaciones Totales: %lld\n", total_ops);
+void convolucion_interior(const unsigned char* input, unsigned char* output, int width,
+                          const float* kernel, int k_size, int y, int x_ini, int x_fin) {
+    interior_despachar(input, (size_t)width, output, (size_t)width, kernel, k_size, y, x_ini, x_fin);
+}
+
+unsigned char convolucion_pixel(const unsigned char* input, int width, int height,
+                                const float* kernel, int k_size, int x, int y) {
+    PlanoImagen plano = { (unsigned char*)input, width, height, (size_t)width };
+    return convolucion_pixel_plano(&plano, kernel, k_size, x, y);
 }
 
-// Función auxiliar visual (Estilo Horizontal)
-void progreso(int y, int height) {
-    // Calcular porcentaje
-    int porcentaje = (y + 1) * 100 / height;
-
-    // Imprimir solo si cambia para no llenar la pantalla
-    if (porcentaje != ultimo_porcentaje) {
-        if (porcentaje % 10 == 0) {
-            printf("%d%% ", porcentaje);
-            fflush(stdout);
-            ultimo_porcentaje = porcentaje;
+unsigned char convolucion_pixel_plano(const PlanoImagen* plano, const float* kernel, int k_size, int x, int y) {
+    int half = k_size / 2;
+    int width = plano->width, height = plano->height;
+    float sum = 0.0f;
+
+    // Convolución: Recorrer la máscara/kernel sobre el pixel actual
+    for (int ky = -half; ky <= half; ky++) {
+        for (int kx = -half; kx <= half; kx++) {
+
+            // Calcular coordenada del pixel vecino
+            int ix = x + kx;
+            int iy = y + ky;
+
+            // Manejo de bordes (Clamp) - Igual que en el Kernel GPU
+            if(ix < 0) ix = 0;
+            if(ix >= width) ix = width - 1;
+            if(iy < 0) iy = 0;
+            if(iy >= height) iy = height - 1;
+
+            // Obtener valor del píxel (0-255) y peso del kernel
+            // Convertimos a float para operar con precisión
+            float pixel_val = (float)plano->datos[(size_t)iy * plano->pitch + ix];
+            float weight = kernel[(ky + half) * k_size + (kx + half)];
+
+            sum += pixel_val * weight;
         }
     }
-}
\ No newline at end of file
+
+    // "Clamp" del resultado final para que encaje en un byte (0-255)
+    if (sum < 0) sum = 0;
+    if (sum > 255) sum = 255;
+
+    return (unsigned char)sum;
+}
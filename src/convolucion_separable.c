@@ -0,0 +1,164 @@
+#include "convolucion_separable.h"
+#include "pool_hilos.h"
+#include "progreso.h"
+
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+// Cada banda hace su pasada horizontal en un buffer propio de
+// (FILAS_POR_BANDA + k_size - 1) filas, que cabe en caché: no hay un
+// intermedio de width * height floats yendo y viniendo de la RAM.
+#define FILAS_POR_BANDA 32
+
+typedef struct {
+    const unsigned char* input;
+    unsigned char* output;
+    size_t pitch_entrada;       // Bytes entre filas de input / output
+    size_t pitch_salida;
+    int width;
+    int height;
+    const FiltroInfo* filtro;
+    atomic_int error;           // Alguna banda no consiguió memoria (sus filas quedan sin escribir)
+    Progreso progreso;
+} TrabajoSeparable;
+
+// Un píxel de la pasada horizontal con clamp (solo para las columnas de borde)
+static float horizontal_borde(const unsigned char* src, int width, const float* pesos, int k_size, int x) {
+    int half = k_size / 2;
+    float sum = 0.0f;
+    for (int j = 0; j < k_size; j++) {
+        int ix = x + j - half;
+        if (ix < 0) ix = 0;
+        if (ix >= width) ix = width - 1;
+        sum += (float)src[ix] * pesos[j];
+    }
+    return sum;
+}
+
+// Pasada 1: dst[x] = sum_j fila[j] * src[clamp(x + j - half)]
+static void pasada_horizontal(const unsigned char* src, float* dst, int width, const FiltroInfo* filtro) {
+    int k_size = filtro->k_size;
+    int half = k_size / 2;
+    const float* pesos = filtro->fila;
+
+    // Tramo de columnas sin clamp
+    int x_ini = half < width ? half : width;
+    int x_fin = width - half > x_ini ? width - half : x_ini;
+
+    // Interior: taps por fuera, píxeles por dentro (se autovectoriza)
+    for (int x = x_ini; x < x_fin; x++) dst[x] = 0.0f;
+    for (int j = 0; j < k_size; j++) {
+        const unsigned char* p = src + j - half;
+        float w = pesos[j];
+        for (int x = x_ini; x < x_fin; x++) dst[x] += (float)p[x] * w;
+    }
+
+    // Bordes izquierdo y derecho con clamp
+    for (int x = 0; x < x_ini; x++) dst[x] = horizontal_borde(src, width, pesos, k_size, x);
+    for (int x = x_fin; x < width; x++) dst[x] = horizontal_borde(src, width, pesos, k_size, x);
+}
+
+// Pasada 2: dst[x] = sat(sum_i columna[i] * filas[i][x])
+static void pasada_vertical(const float* const* filas, unsigned char* dst, float* acc,
+                            int width, const FiltroInfo* filtro) {
+    for (int x = 0; x < width; x++) acc[x] = 0.0f;
+
+    for (int i = 0; i < filtro->k_size; i++) {
+        const float* src = filas[i];
+        float w = filtro->columna[i];
+        for (int x = 0; x < width; x++) acc[x] += src[x] * w;
+    }
+
+    for (int x = 0; x < width; x++) {
+        float sum = acc[x];
+        sum = sum < 0.0f ? 0.0f : sum;
+        sum = sum > 255.0f ? 255.0f : sum;
+        dst[x] = (unsigned char)sum;
+    }
+}
+
+static void procesar_banda(void* contexto, int banda) {
+    TrabajoSeparable* t = (TrabajoSeparable*)contexto;
+    int width = t->width;
+    int height = t->height;
+    int k_size = t->filtro->k_size;
+    int half = k_size / 2;
+
+    int y_ini = banda * FILAS_POR_BANDA;
+    int y_fin = y_ini + FILAS_POR_BANDA < height ? y_ini + FILAS_POR_BANDA : height;
+
+    // Filas de entrada que necesita la banda: [y_ini - half, y_fin + half), recortadas a la imagen
+    int f_ini = y_ini - half < 0 ? 0 : y_ini - half;
+    int f_fin = y_fin + half > height ? height : y_fin + half;
+    int num_filas = f_fin - f_ini;
+
+    float* temp = (float*)malloc(sizeof(float) * (size_t)width * (num_filas + 1));
+    const float** filas = (const float**)malloc(sizeof(float*) * k_size);
+    if (!temp || !filas) {
+        free(temp);
+        free(filas);
+        atomic_store(&t->error, 1);
+        return;
+    }
+    float* acc = temp + (size_t)width * num_filas;
+
+    for (int y = f_ini; y < f_fin; y++) {
+        pasada_horizontal(t->input + (size_t)y * t->pitch_entrada, temp + (size_t)(y - f_ini) * width, width, t->filtro);
+    }
+
+    for (int y = y_ini; y < y_fin; y++) {
+        // El clamp vertical se resuelve una vez por fila de taps
+        for (int i = 0; i < k_size; i++) {
+            int iy = y + i - half;
+            if (iy < 0) iy = 0;
+            if (iy >= height) iy = height - 1;
+            filas[i] = temp + (size_t)(iy - f_ini) * width;
+        }
+        pasada_vertical(filas, t->output + (size_t)y * t->pitch_salida, acc, width, t->filtro);
+    }
+
+    free(temp);
+    free(filas);
+    progreso_avanzar(&t->progreso, y_fin - y_ini);
+}
+
+void convolucion_separable(const unsigned char* input, unsigned char* output,
+                           int width, int height, const FiltroInfo* filtro) {
+    PlanoImagen entrada = { (unsigned char*)input, width, height, (size_t)width };
+    PlanoImagen salida = { output, width, height, (size_t)width };
+    convolucion_separable_plano(&entrada, &salida, filtro);
+}
+
+void convolucion_separable_plano(const PlanoImagen* entrada, const PlanoImagen* salida, const FiltroInfo* filtro) {
+    int height = entrada->height;
+
+    // Sin pool de hilos las bandas se procesan en este hilo (mismo resultado)
+    PoolHilos* pool = pool_global();
+
+    TrabajoSeparable trabajo = {
+        .input = entrada->datos,
+        .output = salida->datos,
+        .pitch_entrada = entrada->pitch,
+        .pitch_salida = salida->pitch,
+        .width = entrada->width,
+        .height = height,
+        .filtro = filtro,
+    };
+    atomic_init(&trabajo.error, 0);
+    progreso_iniciar(&trabajo.progreso, height);
+
+    int num_bandas = (height + FILAS_POR_BANDA - 1) / FILAS_POR_BANDA;
+    if (pool) {
+        pool_ejecutar(pool, num_bandas, procesar_banda, &trabajo);
+    } else {
+        for (int banda = 0; banda < num_bandas; banda++) procesar_banda(&trabajo, banda);
+    }
+
+    progreso_finalizar(&trabajo.progreso);
+    if (atomic_load(&trabajo.error)) {
+        printf("Error: Fallo de memoria en el filtro separable (salida incompleta).\n");
+        return;
+    }
+    printf("[Info] Filtro separable: %d + %d taps por pixel\n", filtro->k_size, filtro->k_size);
+}
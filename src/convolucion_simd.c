@@ -0,0 +1,250 @@
+#include "convolucion_simd.h"
+#include "convolucion_secuencial.h"
+#include "plataforma.h"
+
+#include <pthread.h>
+
+#ifdef PLATAFORMA_X86
+#if defined(_MSC_VER)
+#include <intrin.h>
+#else
+#include <cpuid.h>
+#endif
+#endif
+
+// ============================================
+// 1. Detección de CPU (CPUID)
+// ============================================
+#ifdef PLATAFORMA_X86
+static void cpuid_consultar(unsigned int hoja, unsigned int subhoja, unsigned int regs[4]) {
+#if defined(_MSC_VER)
+    int r[4];
+    __cpuidex(r, (int)hoja, (int)subhoja);
+    for (int i = 0; i < 4; i++) regs[i] = (unsigned int)r[i];
+#else
+    if (!__get_cpuid_count(hoja, subhoja, &regs[0], &regs[1], &regs[2], &regs[3])) {
+        regs[0] = regs[1] = regs[2] = regs[3] = 0;
+    }
+#endif
+}
+
+// XCR0: indica qué registros guarda el sistema operativo en los cambios de contexto
+static unsigned long long xgetbv_leer(void) {
+#if defined(_MSC_VER)
+    return _xgetbv(0);
+#else
+    unsigned int eax, edx;
+    __asm__ volatile("xgetbv" : "=a"(eax), "=d"(edx) : "c"(0));
+    return ((unsigned long long)edx << 32) | eax;
+#endif
+}
+#endif
+
+// Nivel detectado, escrito una sola vez (pthread_once): los hilos del pool lo leen a la vez
+static NivelSIMD nivel_detectado = SIMD_ESCALAR;
+static pthread_once_t nivel_once = PTHREAD_ONCE_INIT;
+
+static void detectar_nivel(void) {
+    NivelSIMD nivel = SIMD_ESCALAR;
+#ifdef PLATAFORMA_X86
+    unsigned int regs[4];
+    cpuid_consultar(0, 0, regs);
+    unsigned int max_hoja = regs[0];
+
+    cpuid_consultar(1, 0, regs);
+    int sse41   = (regs[2] >> 19) & 1;
+    int osxsave = (regs[2] >> 27) & 1;
+    int avx     = (regs[2] >> 28) & 1;
+
+    if (sse41) nivel = SIMD_SSE41;
+
+    // AVX2 requiere además que el SO preserve los registros YMM (bits 1 y 2 de XCR0)
+    if (avx && osxsave && (xgetbv_leer() & 0x6) == 0x6 && max_hoja >= 7) {
+        cpuid_consultar(7, 0, regs);
+        if ((regs[1] >> 5) & 1) nivel = SIMD_AVX2;
+    }
+#endif
+    nivel_detectado = nivel;
+}
+
+NivelSIMD simd_nivel_detectado(void) {
+    pthread_once(&nivel_once, detectar_nivel);
+    return nivel_detectado;
+}
+
+const char* simd_nombre(NivelSIMD nivel) {
+    switch (nivel) {
+        case SIMD_AVX2:  return "AVX2";
+        case SIMD_SSE41: return "SSE4.1";
+        default:         return "Escalar";
+    }
+}
+
+// ============================================
+// 2. Filas vectorizadas
+// ============================================
+// Solo el tramo interior en X [half, width - half) se vectoriza: ahí ninguna
+// columna vecina necesita clamp. Las filas sí se recortan (una vez por ky).
+// Cada carril hace sum += pixel * peso en el mismo orden (ky, kx) que el código
+// escalar y el resultado se satura y trunca igual, por eso la salida es idéntica.
+
+static void fila_escalar(const PlanoImagen* entrada, const PlanoImagen* salida,
+                         const float* kernel, int k_size, int y, int x_ini, int x_fin) {
+    unsigned char* out = salida->datos + (size_t)y * salida->pitch;
+    for (int x = x_ini; x < x_fin; x++) {
+        out[x] = convolucion_pixel_plano(entrada, kernel, k_size, x, y);
+    }
+}
+
+#ifdef PLATAFORMA_X86
+SIMD_DESTINO("sse4.1")
+static int fila_sse41(const unsigned char* input, size_t pitch_in, unsigned char* output, size_t pitch_out, int height,
+                      const float* kernel, int k_size, int y, int x, int x_fin) {
+    int half = k_size / 2;
+    const __m128 cero = _mm_setzero_ps();
+    const __m128 max255 = _mm_set1_ps(255.0f);
+
+    for (; x + 8 <= x_fin; x += 8) {
+        __m128 acc0 = _mm_setzero_ps();
+        __m128 acc1 = _mm_setzero_ps();
+
+        for (int ky = -half; ky <= half; ky++) {
+            int iy = y + ky;
+            if (iy < 0) iy = 0;
+            if (iy >= height) iy = height - 1;
+
+            const unsigned char* fila = input + (size_t)iy * pitch_in + (x - half);
+            const float* pesos = kernel + (ky + half) * k_size;
+
+            for (int kx = 0; kx < k_size; kx++) {
+                // 8 bytes -> 2 x 4 enteros de 32 bits -> 2 x 4 floats
+                __m128i p = _mm_loadl_epi64((const __m128i*)(fila + kx));
+                __m128 f0 = _mm_cvtepi32_ps(_mm_cvtepu8_epi32(p));
+                __m128 f1 = _mm_cvtepi32_ps(_mm_cvtepu8_epi32(_mm_srli_si128(p, 4)));
+                __m128 w = _mm_set1_ps(pesos[kx]);
+
+                acc0 = _mm_add_ps(acc0, _mm_mul_ps(f0, w));
+                acc1 = _mm_add_ps(acc1, _mm_mul_ps(f1, w));
+            }
+        }
+
+        // Saturar a [0, 255], truncar y empaquetar a bytes
+        acc0 = _mm_min_ps(_mm_max_ps(acc0, cero), max255);
+        acc1 = _mm_min_ps(_mm_max_ps(acc1, cero), max255);
+        __m128i w16 = _mm_packus_epi32(_mm_cvttps_epi32(acc0), _mm_cvttps_epi32(acc1));
+        _mm_storel_epi64((__m128i*)(output + (size_t)y * pitch_out + x), _mm_packus_epi16(w16, w16));
+    }
+    return x;
+}
+
+SIMD_DESTINO("avx2")
+static int fila_avx2(const unsigned char* input, size_t pitch_in, unsigned char* output, size_t pitch_out, int height,
+                     const float* kernel, int k_size, int y, int x, int x_fin) {
+    int half = k_size / 2;
+    const __m256 cero = _mm256_setzero_ps();
+    const __m256 max255 = _mm256_set1_ps(255.0f);
+
+    for (; x + 16 <= x_fin; x += 16) {
+        __m256 acc0 = _mm256_setzero_ps();
+        __m256 acc1 = _mm256_setzero_ps();
+
+        for (int ky = -half; ky <= half; ky++) {
+            int iy = y + ky;
+            if (iy < 0) iy = 0;
+            if (iy >= height) iy = height - 1;
+
+            const unsigned char* fila = input + (size_t)iy * pitch_in + (x - half);
+            const float* pesos = kernel + (ky + half) * k_size;
+
+            for (int kx = 0; kx < k_size; kx++) {
+                // 16 bytes -> 2 x 8 enteros de 32 bits -> 2 x 8 floats
+                __m128i p = _mm_loadu_si128((const __m128i*)(fila + kx));
+                __m256 f0 = _mm256_cvtepi32_ps(_mm256_cvtepu8_epi32(p));
+                __m256 f1 = _mm256_cvtepi32_ps(_mm256_cvtepu8_epi32(_mm_srli_si128(p, 8)));
+                __m256 w = _mm256_set1_ps(pesos[kx]);
+
+                // mul + add por separado (sin FMA) para igualar el redondeo escalar
+                acc0 = _mm256_add_ps(acc0, _mm256_mul_ps(f0, w));
+                acc1 = _mm256_add_ps(acc1, _mm256_mul_ps(f1, w));
+            }
+        }
+
+        acc0 = _mm256_min_ps(_mm256_max_ps(acc0, cero), max255);
+        acc1 = _mm256_min_ps(_mm256_max_ps(acc1, cero), max255);
+
+        // packus trabaja por mitades de 128 bits: se reordenan los qwords antes de bajar a bytes
+        __m256i w16 = _mm256_packus_epi32(_mm256_cvttps_epi32(acc0), _mm256_cvttps_epi32(acc1));
+        w16 = _mm256_permute4x64_epi64(w16, 0xD8);
+        __m128i b = _mm_packus_epi16(_mm256_castsi256_si128(w16), _mm256_extracti128_si256(w16, 1));
+        _mm_storeu_si128((__m128i*)(output + (size_t)y * pitch_out + x), b);
+    }
+    return x;
+}
+#endif
+
+// ============================================
+// 3. Motor completo
+// ============================================
+void convolucion_simd(const unsigned char* input, unsigned char* output,
+                      int width, int height, const float* kernel, int k_size) {
+    convolucion_simd_filas(input, output, width, height, kernel, k_size, 0, height);
+}
+
+void convolucion_simd_filas(const unsigned char* input, unsigned char* output,
+                            int width, int height, const float* kernel, int k_size,
+                            int y_ini, int y_fin) {
+    PlanoImagen entrada = { (unsigned char*)input, width, height, (size_t)width };
+    PlanoImagen salida = { output, width, height, (size_t)width };
+    convolucion_simd_plano_filas(&entrada, &salida, kernel, k_size, y_ini, y_fin);
+}
+
+void convolucion_simd_plano(const PlanoImagen* entrada, const PlanoImagen* salida,
+                            const float* kernel, int k_size) {
+    convolucion_simd_plano_filas(entrada, salida, kernel, k_size, 0, entrada->height);
+}
+
+void convolucion_simd_plano_filas(const PlanoImagen* entrada, const PlanoImagen* salida,
+                                  const float* kernel, int k_size, int y_ini, int y_fin) {
+    convolucion_simd_plano_bloque(entrada, salida, kernel, k_size, 0, entrada->width, y_ini, y_fin);
+}
+
+void convolucion_simd_plano_bloque(const PlanoImagen* entrada, const PlanoImagen* salida,
+                                   const float* kernel, int k_size, int x_ini, int x_fin, int y_ini, int y_fin) {
+
+    NivelSIMD nivel = simd_nivel_detectado();
+    int width = entrada->width, height = entrada->height;
+    int half = k_size / 2;
+
+    // Tramo interior en X (puede quedar vacío en imágenes muy estrechas)
+    int int_ini = half < width ? half : width;
+    int int_fin = width - half > int_ini ? width - half : int_ini;
+
+    // Parte del interior que cae en [x_ini, x_fin)
+    int a = int_ini < x_fin ? int_ini : x_fin;
+    if (a < x_ini) a = x_ini;
+    int b = int_fin < x_fin ? int_fin : x_fin;
+    if (b < a) b = a;
+
+    for (int y = y_ini; y < y_fin; y++) {
+        int x = a;
+
+        // Borde izquierdo
+        fila_escalar(entrada, salida, kernel, k_size, y, x_ini, a);
+
+#ifdef PLATAFORMA_X86
+        if (nivel == SIMD_AVX2) {
+            x = fila_avx2(entrada->datos, entrada->pitch, salida->datos, salida->pitch, height, kernel, k_size, y, x, b);
+        }
+        if (nivel >= SIMD_SSE41) {
+            // En AVX2 también aprovecha la cola de 8..15 píxeles
+            x = fila_sse41(entrada->datos, entrada->pitch, salida->datos, salida->pitch, height, kernel, k_size, y, x, b);
+        }
+#else
+        (void)nivel;
+        (void)height;
+#endif
+
+        // Cola del interior + borde derecho
+        fila_escalar(entrada, salida, kernel, k_size, y, x, x_fin);
+    }
+}
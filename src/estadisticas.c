@@ -0,0 +1,35 @@
+#include "estadisticas.h"
+
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+static int comparar_double(const void* a, const void* b) {
+    double x = *(const double*)a, y = *(const double*)b;
+    return (x > y) - (x < y);
+}
+
+int estadisticas_calcular(double* muestras, int n, Estadisticas* e) {
+    memset(e, 0, sizeof(*e));
+    if (n <= 0) return 0;
+
+    qsort(muestras, (size_t)n, sizeof(double), comparar_double);
+    e->n = n;
+    e->min = muestras[0];
+    e->mediana = (n % 2) ? muestras[n / 2] : 0.5 * (muestras[n / 2 - 1] + muestras[n / 2]);
+
+    // Rango más cercano: la menor muestra con al menos el 95% de las muestras a su izquierda
+    int rango = (int)ceil(0.95 * n);
+    e->p95 = muestras[(rango > 0 ? rango : 1) - 1];
+
+    double suma = 0.0;
+    for (int i = 0; i < n; i++) suma += muestras[i];
+    e->media = suma / n;
+
+    if (n > 1) {
+        double cuadrados = 0.0;
+        for (int i = 0; i < n; i++) cuadrados += (muestras[i] - e->media) * (muestras[i] - e->media);
+        e->desviacion = sqrt(cuadrados / (n - 1));
+    }
+    return 1;
+}
@@ -0,0 +1,189 @@
+#include "fft.h"
+
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define PI 3.14159265358979323846
+
+static Complejo cmul(Complejo a, Complejo b) {
+    Complejo r = { a.re * b.re - a.im * b.im, a.re * b.im + a.im * b.re };
+    return r;
+}
+
+int fft_tamano_rapido(int n) {
+    if (n <= 1) return 1;
+    for (int m = n;; m++) {
+        int r = m;
+        while (r % 2 == 0) r /= 2;
+        while (r % 3 == 0) r /= 3;
+        while (r % 5 == 0) r /= 5;
+        if (r == 1) return m;
+    }
+}
+
+int fft_factorizar(int n, int* radices) {
+    int num = 0;
+    while (n % 4 == 0) { radices[num++] = 4; n /= 4; }
+    while (n % 2 == 0) { radices[num++] = 2; n /= 2; }
+    while (n % 3 == 0) { radices[num++] = 3; n /= 3; }
+    while (n % 5 == 0) { radices[num++] = 5; n /= 5; }
+    return n == 1 ? num : 0;
+}
+
+int fft_plan_crear(PlanFFT* plan, int n) {
+    memset(plan, 0, sizeof(*plan));
+    plan->n = n;
+    plan->num_pasos = n > 1 ? fft_factorizar(n, plan->radices) : 0;
+    if (n > 1 && plan->num_pasos == 0) return 0;
+
+    // twiddle[k][r-1] = exp(-2*pi*i * k * r / (ns * radix)), calculado en double
+    int ns = 1;
+    for (int p = 0; p < plan->num_pasos; p++) {
+        int radix = plan->radices[p];
+        plan->twiddles[p] = (Complejo*)malloc(sizeof(Complejo) * ns * (radix - 1));
+        if (!plan->twiddles[p]) {
+            fft_plan_liberar(plan);
+            return 0;
+        }
+        for (int k = 0; k < ns; k++) {
+            for (int r = 1; r < radix; r++) {
+                double ang = -2.0 * PI * k * r / ((double)ns * radix);
+                plan->twiddles[p][k * (radix - 1) + r - 1].re = (float)cos(ang);
+                plan->twiddles[p][k * (radix - 1) + r - 1].im = (float)sin(ang);
+            }
+        }
+        ns *= radix;
+    }
+    return 1;
+}
+
+void fft_plan_liberar(PlanFFT* plan) {
+    for (int p = 0; p < FFT_MAX_PASOS; p++) {
+        free(plan->twiddles[p]);
+        plan->twiddles[p] = NULL;
+    }
+    plan->num_pasos = 0;
+}
+
+// DFT de 'radix' puntos sobre v (radix <= 5). signo = -1 directa, +1 inversa;
+// raices[m] = exp(signo * 2*pi*i * m / radix) (solo se usa para radix 3 y 5).
+static inline void dft_pequena(Complejo* v, int radix, float signo, const Complejo* raices) {
+    Complejo a, b, c, d;
+    switch (radix) {
+    case 2:
+        a = v[0]; b = v[1];
+        v[0].re = a.re + b.re; v[0].im = a.im + b.im;
+        v[1].re = a.re - b.re; v[1].im = a.im - b.im;
+        break;
+    case 4: {
+        // Dos mariposas de radix 2 y rotación por -+i
+        a.re = v[0].re + v[2].re; a.im = v[0].im + v[2].im;
+        b.re = v[0].re - v[2].re; b.im = v[0].im - v[2].im;
+        c.re = v[1].re + v[3].re; c.im = v[1].im + v[3].im;
+        d.re = v[1].re - v[3].re; d.im = v[1].im - v[3].im;
+        // d * (signo * i)
+        Complejo di = { -signo * d.im, signo * d.re };
+        v[0].re = a.re + c.re;  v[0].im = a.im + c.im;
+        v[1].re = b.re + di.re; v[1].im = b.im + di.im;
+        v[2].re = a.re - c.re;  v[2].im = a.im - c.im;
+        v[3].re = b.re - di.re; v[3].im = b.im - di.im;
+        break;
+    }
+    case 3: {
+        // X1,2 = v0 - (v1 + v2) / 2 -+ signo * i * sqrt(3)/2 * (v1 - v2)
+        const float s3 = 0.86602540378443864676f;
+        a.re = v[1].re + v[2].re; a.im = v[1].im + v[2].im;
+        b.re = v[0].re - 0.5f * a.re; b.im = v[0].im - 0.5f * a.im;
+        c.re = -signo * s3 * (v[1].im - v[2].im);
+        c.im = signo * s3 * (v[1].re - v[2].re);
+        v[0].re += a.re;        v[0].im += a.im;
+        v[1].re = b.re + c.re;  v[1].im = b.im + c.im;
+        v[2].re = b.re - c.re;  v[2].im = b.im - c.im;
+        break;
+    }
+    default: {
+        // Radix 5: DFT directa (O(radix^2), pocos puntos)
+        Complejo entrada[5];
+        memcpy(entrada, v, sizeof(Complejo) * radix);
+        for (int s = 0; s < radix; s++) {
+            Complejo acc = { 0.0f, 0.0f };
+            for (int r = 0; r < radix; r++) {
+                Complejo t = cmul(entrada[r], raices[(r * s) % radix]);
+                acc.re += t.re;
+                acc.im += t.im;
+            }
+            v[s] = acc;
+        }
+        break;
+    }
+    }
+}
+
+// Un paso de Stockham sobre 'lote' transformadas intercaladas (el elemento i de la
+// transformada c está en i * lote + c): n / radix mariposas por transformada, de src a dst.
+// Con lote > 1 el bucle interno recorre transformadas contiguas y se vectoriza.
+static inline void paso_stockham(const Complejo* src, Complejo* dst, int n, int lote, int radix, int ns,
+                          const Complejo* twiddles, int inversa) {
+    int m = n / radix;
+    float signo = inversa ? 1.0f : -1.0f;
+
+    Complejo raices[5];
+    for (int r = 0; r < radix; r++) {
+        double ang = signo * 2.0 * PI * r / radix;
+        raices[r].re = (float)cos(ang);
+        raices[r].im = (float)sin(ang);
+    }
+
+    // j = bloque * ns + k: k es la posición dentro de la sub-transformada actual
+    for (int bloque = 0; bloque < m / ns; bloque++) {
+        for (int k = 0; k < ns; k++) {
+            int j = bloque * ns + k;
+            int base = bloque * ns * radix + k;
+
+            Complejo w[5];
+            for (int r = 1; r < radix; r++) {
+                w[r] = twiddles[k * (radix - 1) + r - 1];
+                if (inversa) w[r].im = -w[r].im;
+            }
+
+            for (int c = 0; c < lote; c++) {
+                Complejo v[5];
+
+                // 1. Cargar con paso n / radix y aplicar twiddles
+                v[0] = src[(size_t)j * lote + c];
+                for (int r = 1; r < radix; r++) v[r] = cmul(src[(size_t)(j + r * m) * lote + c], w[r]);
+
+                // 2. Mariposa
+                dft_pequena(v, radix, signo, raices);
+
+                // 3. Escribir ya ordenado
+                for (int r = 0; r < radix; r++) dst[(size_t)(base + r * ns) * lote + c] = v[r];
+            }
+        }
+    }
+}
+
+void fft_ejecutar(const PlanFFT* plan, Complejo* datos, Complejo* temp, int inversa) {
+    fft_ejecutar_lote(plan, datos, temp, 1, inversa);
+}
+
+void fft_ejecutar_lote(const PlanFFT* plan, Complejo* datos, Complejo* temp, int lote, int inversa) {
+    Complejo* src = datos;
+    Complejo* dst = temp;
+    int ns = 1;
+
+    for (int p = 0; p < plan->num_pasos; p++) {
+        // Radix constante en cada llamada: el compilador desenrolla la mariposa
+        switch (plan->radices[p]) {
+        case 2: paso_stockham(src, dst, plan->n, lote, 2, ns, plan->twiddles[p], inversa); break;
+        case 3: paso_stockham(src, dst, plan->n, lote, 3, ns, plan->twiddles[p], inversa); break;
+        case 4: paso_stockham(src, dst, plan->n, lote, 4, ns, plan->twiddles[p], inversa); break;
+        default: paso_stockham(src, dst, plan->n, lote, 5, ns, plan->twiddles[p], inversa); break;
+        }
+        ns *= plan->radices[p];
+        Complejo* t = src; src = dst; dst = t;
+    }
+
+    if (src != datos) memcpy(datos, src, sizeof(Complejo) * plan->n * lote);
+}
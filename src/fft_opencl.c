@@ -0,0 +1,214 @@
+#include "fft_opencl.h"
+#include "fft.h"
+
+#include <stdio.h>
+
+// Debe coincidir con FFT_TILE en convolucion.cl
+#define FFT_TILE 16
+
+// Primer y último evento encolados: el tiempo de GPU es fin(último) - inicio(primero)
+typedef struct {
+    cl_event primero;
+    cl_event ultimo;
+} MedicionGPU;
+
+static void medir(MedicionGPU* m, cl_event evento) {
+    if (!m->primero) {
+        m->primero = evento;
+        return;
+    }
+    if (m->ultimo) clReleaseEvent(m->ultimo);
+    m->ultimo = evento;
+}
+
+static size_t redondear(size_t n, size_t multiplo) {
+    return (n + multiplo - 1) / multiplo * multiplo;
+}
+
+// Todos los pasos de una FFT de tamaño n sobre 'lote' filas contiguas. El resultado
+// queda en *datos (los buffers se intercambian tras cada paso).
+static cl_int encolar_fft_filas(CLManager* mgr, cl_mem* datos, cl_mem* aux, int n, int lote,
+                                int inversa, MedicionGPU* medicion) {
+    cl_kernel kernel = CLManager_GetKernel(mgr, "fft_paso");
+    if (!kernel) return CL_INVALID_KERNEL_NAME;
+
+    int radices[FFT_MAX_PASOS];
+    int num_pasos = fft_factorizar(n, radices);
+    int ns = 1;
+
+    for (int p = 0; p < num_pasos; p++) {
+        cl_int err;
+        err  = clSetKernelArg(kernel, 0, sizeof(cl_mem), datos);
+        err |= clSetKernelArg(kernel, 1, sizeof(cl_mem), aux);
+        err |= clSetKernelArg(kernel, 2, sizeof(int), &n);
+        err |= clSetKernelArg(kernel, 3, sizeof(int), &radices[p]);
+        err |= clSetKernelArg(kernel, 4, sizeof(int), &ns);
+        err |= clSetKernelArg(kernel, 5, sizeof(int), &inversa);
+        if (err != CL_SUCCESS) return err;
+
+        cl_event evento;
+        size_t global[2] = { (size_t)(n / radices[p]), (size_t)lote };
+        err = clEnqueueNDRangeKernel(mgr->queue, kernel, 2, NULL, global, NULL, 0, NULL, &evento);
+        if (err != CL_SUCCESS) return err;
+        medir(medicion, evento);
+
+        cl_mem t = *datos; *datos = *aux; *aux = t;
+        ns *= radices[p];
+    }
+    return CL_SUCCESS;
+}
+
+// src (alto x ancho) -> dst (ancho x alto)
+static cl_int encolar_transponer(CLManager* mgr, cl_mem src, cl_mem dst, int ancho, int alto,
+                                 MedicionGPU* medicion) {
+    cl_kernel kernel = CLManager_GetKernel(mgr, "fft_transponer");
+    if (!kernel) return CL_INVALID_KERNEL_NAME;
+
+    cl_int err;
+    err  = clSetKernelArg(kernel, 0, sizeof(cl_mem), &src);
+    err |= clSetKernelArg(kernel, 1, sizeof(cl_mem), &dst);
+    err |= clSetKernelArg(kernel, 2, sizeof(int), &ancho);
+    err |= clSetKernelArg(kernel, 3, sizeof(int), &alto);
+    if (err != CL_SUCCESS) return err;
+
+    cl_event evento;
+    size_t global[2] = { redondear(ancho, FFT_TILE), redondear(alto, FFT_TILE) };
+    size_t local[2] = { FFT_TILE, FFT_TILE };
+    err = clEnqueueNDRangeKernel(mgr->queue, kernel, 2, NULL, global, local, 0, NULL, &evento);
+    if (err == CL_SUCCESS) medir(medicion, evento);
+    return err;
+}
+
+// FFT 2D directa de *datos (ny filas x nx): filas, transposición y filas otra vez.
+// El espectro queda transpuesto (nx filas x ny) en *datos.
+static cl_int encolar_fft2d_directa(CLManager* mgr, cl_mem* datos, cl_mem* aux, int nx, int ny,
+                                    MedicionGPU* medicion) {
+    cl_int err = encolar_fft_filas(mgr, datos, aux, nx, ny, 0, medicion);
+    if (err == CL_SUCCESS) err = encolar_transponer(mgr, *datos, *aux, nx, ny, medicion);
+    if (err != CL_SUCCESS) return err;
+
+    cl_mem t = *datos; *datos = *aux; *aux = t;
+    return encolar_fft_filas(mgr, datos, aux, ny, nx, 0, medicion);
+}
+
+// Inversa de encolar_fft2d_directa (sin escalar): vuelve a ny filas x nx
+static cl_int encolar_fft2d_inversa(CLManager* mgr, cl_mem* datos, cl_mem* aux, int nx, int ny,
+                                    MedicionGPU* medicion) {
+    cl_int err = encolar_fft_filas(mgr, datos, aux, ny, nx, 1, medicion);
+    if (err == CL_SUCCESS) err = encolar_transponer(mgr, *datos, *aux, ny, nx, medicion);
+    if (err != CL_SUCCESS) return err;
+
+    cl_mem t = *datos; *datos = *aux; *aux = t;
+    return encolar_fft_filas(mgr, datos, aux, nx, ny, 1, medicion);
+}
+
+cl_int fft_opencl_convolucionar(CLManager* mgr, cl_mem d_input, cl_mem d_output, int width, int height,
+                                const float* filter, int k_size, cl_event* primero, cl_event* ultimo) {
+    cl_int err;
+    MedicionGPU medicion = { NULL, NULL };
+    cl_event evento;
+    *primero = NULL;
+    *ultimo = NULL;
+
+    int half = k_size / 2;
+    int nx = fft_tamano_rapido(width + 2 * half);
+    int ny = fft_tamano_rapido(height + 2 * half);
+    size_t bytes = sizeof(cl_float2) * (size_t)nx * ny;
+
+    cl_kernel k_extender = CLManager_GetKernel(mgr, "fft_extender");
+    cl_kernel k_filtro = CLManager_GetKernel(mgr, "fft_colocar_filtro");
+    cl_kernel k_multiplicar = CLManager_GetKernel(mgr, "fft_multiplicar");
+    cl_kernel k_recortar = CLManager_GetKernel(mgr, "fft_recortar");
+    if (!k_extender || !k_filtro || !k_multiplicar || !k_recortar) return CL_INVALID_KERNEL_NAME;
+
+    // 1. Tres buffers complejos: el espectro del filtro ocupa uno y la imagen
+    //    alterna entre los otros dos
+    //    (del pool del CLManager, así las llamadas repetidas no reservan memoria)
+    cl_mem d_a = CLManager_AcquireBuffer(mgr, CL_MEM_READ_WRITE, bytes, &err);
+    cl_mem d_b = CLManager_AcquireBuffer(mgr, CL_MEM_READ_WRITE, bytes, &err);
+    cl_mem d_c = CLManager_AcquireBuffer(mgr, CL_MEM_READ_WRITE, bytes, &err);
+    cl_mem d_pesos = CLManager_AcquireBuffer(mgr, CL_MEM_READ_ONLY, sizeof(float) * k_size * k_size, &err);
+    if (!d_a || !d_b || !d_c || !d_pesos) {
+        if (err == CL_SUCCESS) err = CL_MEM_OBJECT_ALLOCATION_FAILURE;
+        goto cleanup;
+    }
+    err = clEnqueueWriteBuffer(mgr->queue, d_pesos, CL_FALSE, 0, sizeof(float) * k_size * k_size, filter, 0, NULL, NULL);
+    if (err != CL_SUCCESS) goto cleanup;
+
+    size_t global_2d[2] = { (size_t)nx, (size_t)ny };
+
+    // 2. Espectro del filtro
+    err  = clSetKernelArg(k_filtro, 0, sizeof(cl_mem), &d_pesos);
+    err |= clSetKernelArg(k_filtro, 1, sizeof(cl_mem), &d_a);
+    err |= clSetKernelArg(k_filtro, 2, sizeof(int), &k_size);
+    err |= clSetKernelArg(k_filtro, 3, sizeof(int), &nx);
+    err |= clSetKernelArg(k_filtro, 4, sizeof(int), &ny);
+    if (err == CL_SUCCESS) err = clEnqueueNDRangeKernel(mgr->queue, k_filtro, 2, NULL, global_2d, NULL, 0, NULL, &evento);
+    if (err != CL_SUCCESS) goto cleanup;
+    medir(&medicion, evento);
+
+    cl_mem d_filtro = d_a, d_aux = d_b;
+    err = encolar_fft2d_directa(mgr, &d_filtro, &d_aux, nx, ny, &medicion);
+    if (err != CL_SUCCESS) goto cleanup;
+
+    // 3. Espectro de la imagen extendida (en d_c y el buffer que no es del filtro)
+    cl_mem d_imagen = d_c;
+    err  = clSetKernelArg(k_extender, 0, sizeof(cl_mem), &d_input);
+    err |= clSetKernelArg(k_extender, 1, sizeof(cl_mem), &d_imagen);
+    err |= clSetKernelArg(k_extender, 2, sizeof(int), &width);
+    err |= clSetKernelArg(k_extender, 3, sizeof(int), &height);
+    err |= clSetKernelArg(k_extender, 4, sizeof(int), &half);
+    err |= clSetKernelArg(k_extender, 5, sizeof(int), &nx);
+    err |= clSetKernelArg(k_extender, 6, sizeof(int), &ny);
+    if (err == CL_SUCCESS) err = clEnqueueNDRangeKernel(mgr->queue, k_extender, 2, NULL, global_2d, NULL, 0, NULL, &evento);
+    if (err != CL_SUCCESS) goto cleanup;
+    medir(&medicion, evento);
+
+    err = encolar_fft2d_directa(mgr, &d_imagen, &d_aux, nx, ny, &medicion);
+    if (err != CL_SUCCESS) goto cleanup;
+
+    // 4. Producto de espectros (ambos en el mismo layout transpuesto)
+    int total = nx * ny;
+    size_t global_1d = (size_t)total;
+    err  = clSetKernelArg(k_multiplicar, 0, sizeof(cl_mem), &d_imagen);
+    err |= clSetKernelArg(k_multiplicar, 1, sizeof(cl_mem), &d_filtro);
+    err |= clSetKernelArg(k_multiplicar, 2, sizeof(int), &total);
+    if (err == CL_SUCCESS) err = clEnqueueNDRangeKernel(mgr->queue, k_multiplicar, 1, NULL, &global_1d, NULL, 0, NULL, &evento);
+    if (err != CL_SUCCESS) goto cleanup;
+    medir(&medicion, evento);
+
+    // 5. Vuelta al dominio espacial y recorte de la zona útil
+    err = encolar_fft2d_inversa(mgr, &d_imagen, &d_aux, nx, ny, &medicion);
+    if (err != CL_SUCCESS) goto cleanup;
+
+    float escala = 1.0f / ((float)nx * (float)ny);
+    size_t global_salida[2] = { (size_t)width, (size_t)height };
+    err  = clSetKernelArg(k_recortar, 0, sizeof(cl_mem), &d_imagen);
+    err |= clSetKernelArg(k_recortar, 1, sizeof(cl_mem), &d_output);
+    err |= clSetKernelArg(k_recortar, 2, sizeof(int), &width);
+    err |= clSetKernelArg(k_recortar, 3, sizeof(int), &height);
+    err |= clSetKernelArg(k_recortar, 4, sizeof(int), &half);
+    err |= clSetKernelArg(k_recortar, 5, sizeof(int), &nx);
+    err |= clSetKernelArg(k_recortar, 6, sizeof(float), &escala);
+    if (err == CL_SUCCESS) err = clEnqueueNDRangeKernel(mgr->queue, k_recortar, 2, NULL, global_salida, NULL, 0, NULL, &evento);
+    if (err != CL_SUCCESS) goto cleanup;
+    medir(&medicion, evento);
+
+    // 6. Primer y último kernel de la cadena, sin esperar a que terminen
+    *primero = medicion.primero;
+    *ultimo = medicion.ultimo;
+    medicion.primero = NULL;
+    medicion.ultimo = NULL;
+
+cleanup:
+    // Los buffers vuelven al pool con la cadena aún en la cola: el siguiente que los
+    // reciba los usa en la misma cola (en orden), detrás de estos kernels
+    if (err != CL_SUCCESS) clFinish(mgr->queue);
+    if (medicion.primero) clReleaseEvent(medicion.primero);
+    if (medicion.ultimo) clReleaseEvent(medicion.ultimo);
+    CLManager_ReleaseBuffer(mgr, d_a);
+    CLManager_ReleaseBuffer(mgr, d_b);
+    CLManager_ReleaseBuffer(mgr, d_c);
+    CLManager_ReleaseBuffer(mgr, d_pesos);
+    return err;
+}
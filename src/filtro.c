@@ -0,0 +1,65 @@
+#include "filtro.h"
+
+#include <math.h>
+#include <string.h>
+
+int filtro_analizar(const float* pesos, int k_size, FiltroInfo* info) {
+    memset(info, 0, sizeof(*info));
+    info->k_size = k_size;
+    if (k_size <= 0 || k_size > FILTRO_K_MAX) return 0;
+
+    // 1. Pivote: el peso de mayor magnitud
+    int pf = 0, pc = 0;
+    float max_abs = 0.0f;
+    for (int i = 0; i < k_size; i++) {
+        for (int j = 0; j < k_size; j++) {
+            float a = fabsf(pesos[i * k_size + j]);
+            if (a > max_abs) { max_abs = a; pf = i; pc = j; }
+        }
+    }
+
+    // Filtro de caja: todos los pesos idénticos (comparación exacta, como se escriben en el código)
+    info->uniforme = 1;
+    info->peso_uniforme = pesos[0];
+    for (int i = 1; i < k_size * k_size; i++) {
+        if (pesos[i] != pesos[0]) { info->uniforme = 0; break; }
+    }
+
+    // Filtro nulo: separable trivialmente (fila y columna a cero)
+    if (max_abs == 0.0f) {
+        info->separable = 1;
+        return 1;
+    }
+
+    // 2. Si K tiene rango 1, toda fila es múltiplo de la fila del pivote:
+    //    K = columna * fila^T con columna = K[:, pc] y fila = K[pf, :] / pivote.
+    //    Repartimos sqrt(|pivote|) entre ambos vectores para equilibrar magnitudes.
+    float pivote = pesos[pf * k_size + pc];
+    float escala = sqrtf(fabsf(pivote));
+    float signo = pivote < 0.0f ? -1.0f : 1.0f;
+
+    for (int i = 0; i < k_size; i++) {
+        info->columna[i] = pesos[i * k_size + pc] / escala;
+        info->fila[i] = pesos[pf * k_size + i] / (escala * signo);
+    }
+
+    // 3. Error de la reconstrucción
+    float error = 0.0f;
+    for (int i = 0; i < k_size; i++) {
+        for (int j = 0; j < k_size; j++) {
+            float e = fabsf(pesos[i * k_size + j] - info->columna[i] * info->fila[j]);
+            if (e > error) error = e;
+        }
+    }
+    info->error_separable = error;
+    info->separable = error <= FILTRO_TOLERANCIA_SEPARABLE * max_abs;
+    return 1;
+}
+
+int filtro_usar_separable(const FiltroInfo* info) {
+    return info->separable && info->k_size >= FILTRO_K_MIN_SEPARABLE;
+}
+
+int filtro_usar_caja(const FiltroInfo* info) {
+    return info->uniforme && info->k_size >= FILTRO_K_MIN_CAJA;
+}
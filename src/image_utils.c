@@ -1,5 +1,7 @@
 #include "image_utils.h"
 #include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
 
 // Definimos la implementación de STB solo aquí para evitar conflictos
 #define STB_IMAGE_IMPLEMENTATION
@@ -8,28 +10,79 @@
 #define STB_IMAGE_WRITE_IMPLEMENTATION
 #include "stb_image_write.h"
 
-unsigned char* load_image(const char* filename, int* width, int* height, int* channels) {
-    // Forzamos la carga a 1 canal (escala de grises) pasando el último parámetro '1'
-    // Esto simplifica la convolución para empezar.
-    unsigned char* data = stbi_load(filename, width, height, channels, 1);
+unsigned char* load_image(const char* filename, int* width, int* height, int* channels, int canales_deseados) {
+    // stb_image convierte a canales_deseados (1 = escala de grises, 4 = RGBA, 0 = sin conversión)
+    int canales_archivo = 0;
+    unsigned char* data = stbi_load(filename, width, height, &canales_archivo, canales_deseados);
 
     if (data == NULL) {
         printf("Error: No se pudo cargar la imagen %s\n", filename);
         printf("Razon: %s\n", stbi_failure_reason());
     }
+    if (channels) *channels = canales_archivo;
     return data;
 }
 
-void save_image(const char* filename, int width, int height, unsigned char* data) {
-    // Guardamos en formato PNG, 1 canal (Grises)
-    // El último parámetro es el "stride" (ancho en bytes), que para 1 byte/pixel es el ancho.
-    if (stbi_write_png(filename, width, height, 1, data, width) == 0) {
+unsigned char* load_image_en(const char* filename, int* width, int* height, int* channels,
+                             int canales_deseados, ReservaImagen reservar, void* contexto) {
+    // stb_image siempre decodifica en memoria propia: una copia en el host
+    // (barata) evita la copia intermedia del driver en cada transferencia
+    unsigned char* decodificada = load_image(filename, width, height, channels, canales_deseados);
+    if (!decodificada) return NULL;
+
+    int canales = canales_deseados ? canales_deseados : *channels;
+    size_t bytes = (size_t)(*width) * (*height) * canales;
+    unsigned char* data = reservar(contexto, bytes);
+    if (data) {
+        memcpy(data, decodificada, bytes);
+    } else {
+        printf("Error: No hay memoria para la imagen %s\n", filename);
+    }
+    stbi_image_free(decodificada);
+    return data;
+}
+
+void save_image(const char* filename, int width, int height, int canales, const unsigned char* data) {
+    // Guardamos en formato PNG con los canales recibidos
+    // El último parámetro es el "stride" (ancho en bytes de una fila).
+    if (stbi_write_png(filename, width, height, canales, data, width * canales) == 0) {
         printf("Error: No se pudo guardar la imagen en %s\n", filename);
     } else {
         printf("Imagen guardada: %s\n", filename);
     }
 }
 
+void save_image_canales(const char* filename, int width, int height, int canales_datos,
+                        int canales_archivo, const unsigned char* data) {
+    if (canales_archivo == canales_datos || canales_archivo < 1 || canales_archivo > 4) {
+        save_image(filename, width, height, canales_datos, data);
+        return;
+    }
+
+    size_t num_pixels = (size_t)width * height;
+    unsigned char* convertida = (unsigned char*)malloc(num_pixels * canales_archivo);
+    if (!convertida) {
+        printf("Error: No hay memoria para guardar %s\n", filename);
+        return;
+    }
+
+    // Alfa: último canal en 2 y 4 canales
+    int alfa_datos = (canales_datos == 2 || canales_datos == 4);
+    int alfa_archivo = (canales_archivo == 2 || canales_archivo == 4);
+    int color_archivo = alfa_archivo ? canales_archivo - 1 : canales_archivo;
+    int color_datos = alfa_datos ? canales_datos - 1 : canales_datos;
+
+    for (size_t i = 0; i < num_pixels; i++) {
+        const unsigned char* src = data + i * canales_datos;
+        unsigned char* dst = convertida + i * canales_archivo;
+        for (int c = 0; c < color_archivo; c++) dst[c] = src[c < color_datos ? c : 0];
+        if (alfa_archivo) dst[color_archivo] = alfa_datos ? src[canales_datos - 1] : 255;
+    }
+
+    save_image(filename, width, height, canales_archivo, convertida);
+    free(convertida);
+}
+
 void free_image(unsigned char* data) {
     stbi_image_free(data);
 }
\ No newline at end of file
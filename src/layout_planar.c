@@ -0,0 +1,181 @@
+#include "layout_planar.h"
+#include "convolucion_simd.h"
+#include "image_utils.h"
+#include "plataforma.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Píxeles por iteración de los shuffles: 16 (un registro de 16 bytes por plano)
+#define PIXELES_BLOQUE 16
+
+// ============================================
+// 1. Reserva
+// ============================================
+size_t planar_pitch(int width) {
+    return ((size_t)width + PLANAR_ALINEACION - 1) / PLANAR_ALINEACION * PLANAR_ALINEACION;
+}
+
+int planar_crear(ImagenPlanar* img, int width, int height, int canales) {
+    memset(img, 0, sizeof(*img));
+    if (canales < 1 || canales > PLANAR_MAX_CANALES || width <= 0 || height <= 0) return 0;
+
+    size_t pitch = planar_pitch(width);
+    size_t bytes_plano = pitch * (size_t)height;
+    img->memoria = (unsigned char*)reservar_alineado(bytes_plano * canales, PLANAR_ALINEACION);
+    if (!img->memoria) return 0;
+    memset(img->memoria, 0, bytes_plano * canales);
+
+    img->width = width;
+    img->height = height;
+    img->canales = canales;
+    img->pitch = pitch;
+    for (int c = 0; c < canales; c++) img->planos[c] = img->memoria + bytes_plano * c;
+    return 1;
+}
+
+void planar_liberar(ImagenPlanar* img) {
+    if (img->memoria) liberar_alineado(img->memoria);
+    memset(img, 0, sizeof(*img));
+}
+
+PlanoImagen planar_plano(const ImagenPlanar* img, int canal) {
+    PlanoImagen plano = { img->planos[canal], img->width, img->height, img->pitch };
+    return plano;
+}
+
+// ============================================
+// 2. Shuffles
+// ============================================
+// 16 píxeles de C canales ocupan C registros de 16 bytes. El byte i del plano c
+// es el byte C*i + c del bloque, que está en el registro (C*i + c) / 16: cada
+// plano se arma con C pshufb (uno por registro de origen, 0x80 = byte a cero)
+// combinados con OR. Entrelazar es la misma tabla al revés.
+typedef struct {
+    unsigned char separar[PLANAR_MAX_CANALES][PLANAR_MAX_CANALES][16];  // [plano][registro origen]
+    unsigned char juntar[PLANAR_MAX_CANALES][PLANAR_MAX_CANALES][16];   // [registro destino][plano]
+} MascarasShuffle;
+
+static void mascaras_calcular(MascarasShuffle* m, int canales) {
+    memset(m, 0x80, sizeof(*m));
+    for (int g = 0; g < PIXELES_BLOQUE * canales; g++) {
+        int pixel = g / canales, canal = g % canales;
+        int registro = g / 16, byte = g % 16;
+        m->separar[canal][registro][pixel] = (unsigned char)byte;
+        m->juntar[registro][canal][byte] = (unsigned char)pixel;
+    }
+}
+
+#ifdef PLATAFORMA_X86
+SIMD_DESTINO("ssse3")
+static int desentrelazar_fila_ssse3(const unsigned char* src, unsigned char* const* dst, int canales,
+                                    int width, const MascarasShuffle* m) {
+    int x = 0;
+    for (; x + PIXELES_BLOQUE <= width; x += PIXELES_BLOQUE) {
+        __m128i regs[PLANAR_MAX_CANALES];
+        for (int r = 0; r < canales; r++) regs[r] = _mm_loadu_si128((const __m128i*)(src + (size_t)x * canales + 16 * r));
+
+        for (int c = 0; c < canales; c++) {
+            __m128i plano = _mm_setzero_si128();
+            for (int r = 0; r < canales; r++) {
+                __m128i mascara = _mm_loadu_si128((const __m128i*)m->separar[c][r]);
+                plano = _mm_or_si128(plano, _mm_shuffle_epi8(regs[r], mascara));
+            }
+            _mm_storeu_si128((__m128i*)(dst[c] + x), plano);
+        }
+    }
+    return x;
+}
+
+SIMD_DESTINO("ssse3")
+static int entrelazar_fila_ssse3(unsigned char* const* src, unsigned char* dst, int canales,
+                                 int width, const MascarasShuffle* m) {
+    int x = 0;
+    for (; x + PIXELES_BLOQUE <= width; x += PIXELES_BLOQUE) {
+        __m128i planos[PLANAR_MAX_CANALES];
+        for (int c = 0; c < canales; c++) planos[c] = _mm_loadu_si128((const __m128i*)(src[c] + x));
+
+        for (int r = 0; r < canales; r++) {
+            __m128i reg = _mm_setzero_si128();
+            for (int c = 0; c < canales; c++) {
+                __m128i mascara = _mm_loadu_si128((const __m128i*)m->juntar[r][c]);
+                reg = _mm_or_si128(reg, _mm_shuffle_epi8(planos[c], mascara));
+            }
+            _mm_storeu_si128((__m128i*)(dst + (size_t)x * canales + 16 * r), reg);
+        }
+    }
+    return x;
+}
+#endif
+
+void planar_desentrelazar(const unsigned char* entrelazada, ImagenPlanar* img) {
+    int canales = img->canales;
+    MascarasShuffle m;
+    int usar_simd = canales > 1 && simd_nivel_detectado() >= SIMD_SSE41;  // SSE4.1 implica SSSE3
+    if (usar_simd) mascaras_calcular(&m, canales);
+
+    for (int y = 0; y < img->height; y++) {
+        const unsigned char* src = entrelazada + (size_t)y * img->width * canales;
+        unsigned char* dst[PLANAR_MAX_CANALES];
+        for (int c = 0; c < canales; c++) dst[c] = img->planos[c] + (size_t)y * img->pitch;
+
+        int x = 0;
+#ifdef PLATAFORMA_X86
+        if (usar_simd) x = desentrelazar_fila_ssse3(src, dst, canales, img->width, &m);
+#endif
+        for (; x < img->width; x++) {
+            for (int c = 0; c < canales; c++) dst[c][x] = src[(size_t)x * canales + c];
+        }
+    }
+}
+
+void planar_entrelazar(const ImagenPlanar* img, unsigned char* entrelazada) {
+    int canales = img->canales;
+    MascarasShuffle m;
+    int usar_simd = canales > 1 && simd_nivel_detectado() >= SIMD_SSE41;
+    if (usar_simd) mascaras_calcular(&m, canales);
+
+    for (int y = 0; y < img->height; y++) {
+        unsigned char* dst = entrelazada + (size_t)y * img->width * canales;
+        unsigned char* src[PLANAR_MAX_CANALES];
+        for (int c = 0; c < canales; c++) src[c] = img->planos[c] + (size_t)y * img->pitch;
+
+        int x = 0;
+#ifdef PLATAFORMA_X86
+        if (usar_simd) x = entrelazar_fila_ssse3(src, dst, canales, img->width, &m);
+#endif
+        for (; x < img->width; x++) {
+            for (int c = 0; c < canales; c++) dst[(size_t)x * canales + c] = src[c][x];
+        }
+    }
+}
+
+// ============================================
+// 3. Carga y guardado
+// ============================================
+int planar_cargar(const char* filename, ImagenPlanar* img) {
+    int width, height, canales;
+    unsigned char* entrelazada = load_image(filename, &width, &height, &canales, 0);
+    if (!entrelazada) return 0;
+
+    int ok = planar_crear(img, width, height, canales);
+    if (ok) {
+        planar_desentrelazar(entrelazada, img);
+    } else {
+        printf("Error: No hay memoria para la imagen planar %s\n", filename);
+    }
+    free_image(entrelazada);
+    return ok;
+}
+
+void planar_guardar(const char* filename, const ImagenPlanar* img) {
+    unsigned char* entrelazada = (unsigned char*)malloc((size_t)img->width * img->height * img->canales);
+    if (!entrelazada) {
+        printf("Error: No hay memoria para guardar %s\n", filename);
+        return;
+    }
+    planar_entrelazar(img, entrelazada);
+    save_image(filename, img->width, img->height, img->canales, entrelazada);
+    free(entrelazada);
+}
@@ -1,11 +1,56 @@
 #include <stdio.h>
 #include <stdlib.h>
-#include <time.h>
+#include <string.h>
 
 #include "image_utils.h"
 #include "cl_manager.h"
 #include "convolucion_secuencial.h"
 #include "convolucion_paralelo.h"
+#include "convolucion_simd.h"
+#include "convolucion_hilos.h"
+#include "convolucion_auto.h"
+#include "convolucion_fft.h"
+#include "convolucion_color.h"
+#include "layout_planar.h"
+#include "convolucion_roi.h"
+#include "reloj.h"
+#include "resultados.h"
+
+// Regiones de interés que se aceptan por línea de comandos (--roi)
+#define MAX_REGIONES 16
+
+// Motores de CPU disponibles (todos con la misma firma que convolucion_secuencial)
+typedef struct {
+    const char* nombre;
+    MotorConvolucionCPU funcion;
+    MotorConvolucionPlano plano;    // Variante con pitch (modo --planar)
+} OpcionMotorCPU;
+
+static const OpcionMotorCPU motores_cpu[] = {
+    { "secuencial", convolucion_secuencial, convolucion_secuencial_plano },
+    { "simd",       convolucion_simd,       convolucion_simd_plano },
+    { "hilos",      convolucion_hilos,      convolucion_hilos_plano },
+    { "fft",        convolucion_fft,        convolucion_fft_plano },
+    { "auto",       convolucion_auto,       convolucion_auto_plano },
+};
+
+static const OpcionMotorCPU* buscar_motor_cpu(const char* nombre) {
+    for (size_t i = 0; i < sizeof(motores_cpu) / sizeof(motores_cpu[0]); i++) {
+        if (strcmp(motores_cpu[i].nombre, nombre) == 0) return &motores_cpu[i];
+    }
+    return NULL;
+}
+
+// Reserva de la imagen de entrada en memoria de CLManager (ver load_image_en)
+static unsigned char* reservar_host(void* contexto, size_t bytes) {
+    return CLManager_AllocHost((CLManager*)contexto, bytes);
+}
+
+// Una fase medida una sola vez (modo --json): bytes = datos que procesa la fase
+static void registrar_fase(TablaBench* tabla, const char* motor, const char* fase,
+                           int width, int height, int k_size, double ms, double bytes) {
+    tabla_agregar(tabla, motor, fase, width, height, k_size, "caja", &ms, 1, bytes);
+}
 
 // Helper visual para títulos bonitos
 void imprimir_titulo(const char* titulo) {
@@ -15,7 +60,113 @@ void imprimir_titulo(const char* titulo) {
     printf("╚════════════════════════════════════════════════════╝\n");
 }
 
-int main() {
+// Modo --planar: la imagen se separa en un plano por canal (con pitch alineado) y
+// cada plano pasa por los motores de un canal (el de --cpu y el de OpenCL)
+static int procesar_planar(CLManager* mgr, const OpcionMotorCPU* motor, const char* ruta_imagen,
+                           const float* kernel, int k_size, int filtrar_alpha) {
+    ImagenPlanar entrada, cpu = { 0 }, gpu = { 0 };
+    if (!planar_cargar(ruta_imagen, &entrada)) return 0;
+    printf("-> Imagen Cargada: %d x %d pixeles, %d planos con pitch de %zu bytes\n",
+           entrada.width, entrada.height, entrada.canales, entrada.pitch);
+
+    int ok = planar_crear(&cpu, entrada.width, entrada.height, entrada.canales) &&
+             planar_crear(&gpu, entrada.width, entrada.height, entrada.canales);
+    if (!ok) {
+        printf("Error: No hay memoria para los planos de salida\n");
+        goto cleanup;
+    }
+
+    // En GA y RGBA el último plano es alfa: con --sin-alpha se copia sin filtrar
+    int con_alpha = (entrada.canales == 2 || entrada.canales == 4);
+    int planos_filtrados = (con_alpha && !filtrar_alpha) ? entrada.canales - 1 : entrada.canales;
+    size_t bytes_plano = entrada.pitch * (size_t)entrada.height;
+
+    imprimir_titulo("FASE 1: PLANOS EN CPU");
+    printf("-> Motor CPU: %s por plano\n", motor->nombre);
+    double start = reloj_ms();
+    for (int c = 0; c < planos_filtrados; c++) {
+        PlanoImagen plano_in = planar_plano(&entrada, c), plano_out = planar_plano(&cpu, c);
+        motor->plano(&plano_in, &plano_out, kernel, k_size);
+    }
+    if (planos_filtrados < entrada.canales) memcpy(cpu.planos[planos_filtrados], entrada.planos[planos_filtrados], bytes_plano);
+    double time_cpu_ms = reloj_ms() - start;
+    printf(">> Tiempo CPU: %.4f ms\n", time_cpu_ms);
+    planar_guardar("img_output/resultado_cpu.png", &cpu);
+
+    imprimir_titulo("FASE 2: PLANOS EN GPU");
+    double kernel_total_ms = 0.0;
+    start = reloj_ms();
+    for (int c = 0; c < planos_filtrados; c++) {
+        double kernel_time_ms = 0.0;
+        PlanoImagen plano_in = planar_plano(&entrada, c), plano_out = planar_plano(&gpu, c);
+        convolucion_paralelo_plano(mgr, &plano_in, &plano_out, kernel, k_size, &kernel_time_ms);
+        kernel_total_ms += kernel_time_ms;
+    }
+    if (planos_filtrados < entrada.canales) memcpy(gpu.planos[planos_filtrados], entrada.planos[planos_filtrados], bytes_plano);
+    double total_gpu_time_ms = reloj_ms() - start;
+    printf("  1. Tiempo Total (Host + Transferencias): %10.4f ms\n", total_gpu_time_ms);
+    printf("  2. Tiempo Puro de Kernel (GPU Compute):  %10.4f ms\n", kernel_total_ms);
+    planar_guardar("img_output/resultado_gpu.png", &gpu);
+
+cleanup:
+    planar_liberar(&gpu);
+    planar_liberar(&cpu);
+    planar_liberar(&entrada);
+    return ok;
+}
+
+int main(int argc, char* argv[]) {
+    // --- ARGUMENTOS ---
+    // Uso: programa [imagen] [--cpu secuencial|simd|hilos|fft|auto] [--frames N] [--color [--sin-alpha]] [--planar]
+    //               [--roi x,y,ancho,alto]... [--json ruta] [--ajustar] [--imagen]
+    const char* ruta_imagen = "img_input/input.png";
+    const char* nombre_motor = "secuencial";
+    int num_frames = 0;     // > 0: además procesa la imagen como secuencia de N frames
+    int color = 0;          // 1: RGBA entrelazado en vez de escala de grises
+    int filtrar_alpha = 1;  // 0: el canal alfa se copia sin filtrar
+    int planar = 0;         // 1: canales del archivo separados en planos (SoA)
+    RegionROI regiones[MAX_REGIONES];
+    int num_regiones = 0;   // > 0: además calcula solo esas regiones
+    const char* ruta_json = NULL;   // Tiempos de cada fase en JSON (ver comparar_resultados)
+    int ajustar = 0;        // 1: autotuning de work-groups antes de la fase de GPU
+    int usar_imagen = 0;    // 1: la GPU lee la entrada como image2d_t (sampler con clamp-to-edge)
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--cpu") == 0 && i + 1 < argc) {
+            nombre_motor = argv[++i];
+        } else if (strcmp(argv[i], "--frames") == 0 && i + 1 < argc) {
+            num_frames = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--color") == 0) {
+            color = 1;
+        } else if (strcmp(argv[i], "--sin-alpha") == 0) {
+            filtrar_alpha = 0;
+        } else if (strcmp(argv[i], "--planar") == 0) {
+            planar = 1;
+        } else if (strcmp(argv[i], "--roi") == 0 && i + 1 < argc) {
+            RegionROI* r = &regiones[num_regiones];
+            if (num_regiones == MAX_REGIONES ||
+                sscanf(argv[++i], "%d,%d,%d,%d", &r->x, &r->y, &r->width, &r->height) != 4) {
+                printf("Error: --roi espera x,y,ancho,alto (maximo %d regiones)\n", MAX_REGIONES);
+                return 1;
+            }
+            num_regiones++;
+        } else if (strcmp(argv[i], "--json") == 0 && i + 1 < argc) {
+            ruta_json = argv[++i];
+        } else if (strcmp(argv[i], "--ajustar") == 0) {
+            ajustar = 1;
+        } else if (strcmp(argv[i], "--imagen") == 0) {
+            usar_imagen = 1;
+        } else {
+            ruta_imagen = argv[i];
+        }
+    }
+
+    const OpcionMotorCPU* motor = buscar_motor_cpu(nombre_motor);
+    if (!motor) {
+        printf("Error: Motor de CPU desconocido '%s' (opciones: secuencial, simd, hilos, fft, auto)\n", nombre_motor);
+        return 1;
+    }
+
     // --- SETUP ---
     imprimir_titulo("CONFIGURACIÓN  E  INICIALIZACIÓN");
 
@@ -28,55 +179,113 @@ int main() {
     };
     printf("-> Filtro Definido: Box Blur 3x3\n");
 
-    // 2. Imagen
-    int width, height, channels;
-    unsigned char* img_data = load_image("img_input/input.png", &width, &height, &channels);
-    if (!img_data) return 1;
-    printf("-> Imagen Cargada: %d x %d pixeles\n", width, height);
-
-    // 3. OpenCL Init
+    // 2. OpenCL Init (antes que la imagen: la imagen va a memoria lista para transferir)
     CLManager mgr;
+    double start = reloj_ms();
     if (!CLManager_Init(&mgr)) return 1; // El manager imprime el hardware detectado
+    double init_ms = reloj_ms() - start;
+    start = reloj_ms();
     if (!CLManager_LoadKernel(&mgr, "kernels/convolucion.cl", "conv2d")) return 1;
+    if (!color) convolucion_paralelo_especializar(&mgr, kernel_blur, k_size);
+    double build_ms = reloj_ms() - start;
+    convolucion_paralelo_calibrar(&mgr, k_size);    // Fuera de la compilación y de la fase GPU medidas
+
+    if (planar) {
+        if (ruta_json) printf("Aviso: --json no admite el modo --planar, no se guardan los tiempos.\n");
+        int ok = procesar_planar(&mgr, motor, ruta_imagen, kernel_blur, k_size, filtrar_alpha);
+        imprimir_titulo("LIMPIEZA Y SALIDA");
+        CLManager_PrintPoolStats(&mgr);
+        CLManager_Cleanup(&mgr);
+        return ok ? 0 : 1;
+    }
+
+    // 3. Imagen, en memoria pinned o zero-copy de CLManager_AllocHost.
+    //    En color siempre RGBA (uchar4 en la GPU); se guarda con los canales del archivo
+    int width, height, channels;
+    int canales = color ? 4 : 1;
+    start = reloj_ms();
+    unsigned char* img_data = load_image_en(ruta_imagen, &width, &height, &channels, canales, reservar_host, &mgr);
+    if (!img_data) return 1;
+    double load_ms = reloj_ms() - start;
+    printf("-> Imagen Cargada: %d x %d pixeles, %d canales (procesada con %d)\n", width, height, channels, canales);
+    size_t img_bytes = (size_t)width * height * canales;
 
 
     // --- SEMANA 1: CPU ---
     imprimir_titulo("FASE 1: PROCESAMIENTO SECUENCIAL (CPU)");
 
-    unsigned char* cpu_result = (unsigned char*)malloc(width * height);
+    unsigned char* cpu_result = (unsigned char*)malloc(img_bytes);
+
+    if (color) {
+        // Los motores de --cpu son de un canal: en color se usa el motor entrelazado
+        printf("-> Motor CPU: color (%d canales entrelazados)\n", canales);
+    } else {
+        printf("-> Motor CPU: %s", motor->nombre);
+        if (motor->funcion == convolucion_simd) printf(" (%s)", simd_nombre(simd_nivel_detectado()));
+        printf("\n");
+    }
 
     printf("Procesando... (Esto puede tardar)\n");
-    clock_t start = clock();
+    start = reloj_ms();
 
     // La función hace el trabajo sucio en silencio
-    convolucion_secuencial(img_data, cpu_result, width, height, kernel_blur, k_size);
-
-    clock_t end = clock();
-    double time_cpu = (double)(end - start) / CLOCKS_PER_SEC;
+    if (color) {
+        convolucion_color(img_data, cpu_result, width, height, canales, kernel_blur, k_size, filtrar_alpha);
+    } else {
+        motor->funcion(img_data, cpu_result, width, height, kernel_blur, k_size);
+    }
 
-    // ¡AGREGA ESTA LÍNEA! Convertimos a milisegundos para comparar con la GPU
-    double time_cpu_ms = time_cpu * 1000.0;
+    // Reloj de pared monotónico: clock() suma el tiempo de CPU de todos los hilos
+    double time_cpu_ms = reloj_ms() - start;
+    double time_cpu = time_cpu_ms / 1000.0;
 
     printf(">> Completado.\n");
     printf(">> Tiempo CPU: %.4f segundos\n", time_cpu);
-    save_image("img_output/resultado_cpu.png", width, height, cpu_result);
+    start = reloj_ms();
+    save_image_canales("img_output/resultado_cpu.png", width, height, canales, channels, cpu_result);
+    double save_cpu_ms = reloj_ms() - start;
 
 
     // --- SEMANA 2 y 3: GPU ---
     imprimir_titulo("FASE 2: PROCESAMIENTO PARALELO (GPU)");
 
-    unsigned char* gpu_result = (unsigned char*)malloc(width * height);
+    // El ajuste queda en disco: las ejecuciones siguientes ya lanzan con el mejor work-group
+    if (ajustar && color) {
+        printf("Aviso: --ajustar solo admite escala de grises, se omite el ajuste.\n");
+    } else if (ajustar) {
+        convolucion_paralelo_ajustar(&mgr, width, height, k_size, 3);
+    }
+
+    if (usar_imagen && color) {
+        printf("Aviso: --imagen solo admite escala de grises, se usan buffers.\n");
+        usar_imagen = 0;
+    }
+
+    unsigned char* gpu_result = CLManager_AllocHost(&mgr, img_bytes);
     double kernel_time_ms = 0.0;
+    TiemposGPU tiempos_gpu = { 0.0, 0.0, 0.0 };    // En color solo se mide el kernel
 
     printf("Lanzando Kernel OpenCL...\n");
-    // Medimos tiempo de host (aproximado) para comparar por ahora
-    start = clock();
+    // Tiempo de host de una sola ejecución (incluye la primera compilación JIT;
+    // para medidas estables usar bench_convolucion)
+    start = reloj_ms();
 
     // La función hace todo el trabajo de OpenCL en silencio
-    convolucion_paralelo(&mgr, img_data, gpu_result, width, height, kernel_blur, k_size, &kernel_time_ms);
+    if (color) {
+        convolucion_paralelo_rgba(&mgr, img_data, gpu_result, width, height, kernel_blur, k_size,
+                                  filtrar_alpha, &kernel_time_ms);
+    } else {
+        PlanoImagen plano_in = { img_data, width, height, (size_t)width };
+        PlanoImagen plano_out = { gpu_result, width, height, (size_t)width };
+        if (usar_imagen && !convolucion_paralelo_imagen(&mgr, &plano_in, &plano_out, kernel_blur, k_size, &tiempos_gpu)) {
+            printf("Aviso: sin imagenes OpenCL, se usan buffers.\n");
+            usar_imagen = 0;
+        }
+        if (!usar_imagen) convolucion_paralelo_fases(&mgr, &plano_in, &plano_out, kernel_blur, k_size, &tiempos_gpu);
+        kernel_time_ms = tiempos_gpu.kernel_ms;
+    }
 
-    end = clock();
-    double total_gpu_time_ms = ((double)(end - start) / CLOCKS_PER_SEC)*1000.0;
+    double total_gpu_time_ms = reloj_ms() - start;
 
     printf(">> Completado.\n");
 
@@ -91,16 +300,126 @@ int main() {
         printf(">> Speedup Estimado: %.2fx mas rapido\n", time_cpu_ms / kernel_time_ms);
     }
 
-    save_image("img_output/resultado_gpu.png", width, height, gpu_result);
+    start = reloj_ms();
+    save_image_canales("img_output/resultado_gpu.png", width, height, canales, channels, gpu_result);
+    double save_gpu_ms = reloj_ms() - start;
+
+    // Tiempos de cada fase en formato de tabla de resultados (comparables con comparar_resultados)
+    if (ruta_json) {
+        TablaBench tabla;
+        tabla_iniciar(&tabla);
+        const char* motor_cpu = color ? "color" : motor->nombre;
+        const char* motor_gpu = usar_imagen ? "opencl-img" : "opencl";
+        registrar_fase(&tabla, "programa", "inicializacion", width, height, k_size, init_ms, 0.0);
+        registrar_fase(&tabla, "programa", "compilacion", width, height, k_size, build_ms, 0.0);
+        registrar_fase(&tabla, "programa", "carga", width, height, k_size, load_ms, (double)img_bytes);
+        registrar_fase(&tabla, motor_cpu, "total", width, height, k_size, time_cpu_ms, 2.0 * img_bytes);
+        registrar_fase(&tabla, motor_cpu, "guardado", width, height, k_size, save_cpu_ms, (double)img_bytes);
+        registrar_fase(&tabla, motor_gpu, "total", width, height, k_size, total_gpu_time_ms, 2.0 * img_bytes);
+        if (!color) {
+            registrar_fase(&tabla, motor_gpu, "subida", width, height, k_size, tiempos_gpu.subida_ms, (double)img_bytes);
+        }
+        registrar_fase(&tabla, motor_gpu, "kernel", width, height, k_size, kernel_time_ms, 2.0 * img_bytes);
+        if (!color) {
+            registrar_fase(&tabla, motor_gpu, "bajada", width, height, k_size, tiempos_gpu.bajada_ms, (double)img_bytes);
+        }
+        registrar_fase(&tabla, motor_gpu, "guardado", width, height, k_size, save_gpu_ms, (double)img_bytes);
+        if (tabla_escribir_json(&tabla, ruta_json)) printf("-> Tiempos guardados: %s\n", ruta_json);
+        tabla_liberar(&tabla);
+    }
+
+
+    // --- SECUENCIA DE FRAMES (opcional) ---
+    if (num_frames > 0 && color) {
+        printf("Aviso: --frames solo admite escala de grises, se omite la secuencia.\n");
+    } else if (num_frames > 0) {
+        imprimir_titulo("FASE 3: SECUENCIA DE FRAMES (GPU)");
+
+        // Todos los frames son la misma imagen: solo interesa el solapamiento
+        const unsigned char** entradas = (const unsigned char**)malloc(sizeof(unsigned char*) * num_frames);
+        unsigned char** salidas = (unsigned char**)malloc(sizeof(unsigned char*) * num_frames);
+        unsigned char* bloque = (unsigned char*)malloc((size_t)width * height * num_frames);
+
+        if (entradas && salidas && bloque) {
+            for (int f = 0; f < num_frames; f++) {
+                entradas[f] = img_data;
+                salidas[f] = bloque + (size_t)width * height * f;
+            }
+
+            EstadisticasSecuencia stats;
+            if (convolucion_paralelo_secuencia(&mgr, entradas, salidas, num_frames, width, height,
+                                               kernel_blur, k_size, 2, &stats)) {
+                printf(">> %d frames en %.4f ms (%.4f ms/frame), solapamiento %.1f%%\n",
+                       stats.frames, stats.total_ms, stats.total_ms / stats.frames, 100.0 * stats.solapamiento);
+                printf(">> Ultimo frame %s al resultado de la FASE 2\n",
+                       memcmp(salidas[num_frames - 1], gpu_result, (size_t)width * height) == 0 ? "identico" : "DISTINTO");
+            }
+        }
+        free(entradas);
+        free(salidas);
+        free(bloque);
+    }
+
+
+    // --- REGIONES DE INTERÉS (opcional) ---
+    if (num_regiones > 0 && color) {
+        printf("Aviso: --roi solo admite escala de grises, se omiten las regiones.\n");
+    } else if (num_regiones > 0) {
+        imprimir_titulo("FASE 4: REGIONES DE INTERES (CPU + GPU)");
+
+        // Fuera de las regiones la salida conserva la imagen original
+        unsigned char* roi_cpu = (unsigned char*)malloc(img_bytes);
+        unsigned char* roi_gpu = (unsigned char*)malloc(img_bytes);
+        unsigned char* referencia = (unsigned char*)malloc(img_bytes);
+        if (roi_cpu && roi_gpu && referencia) {
+            memcpy(roi_cpu, img_data, img_bytes);
+            memcpy(roi_gpu, img_data, img_bytes);
+            PlanoImagen plano_in = { img_data, width, height, (size_t)width };
+            PlanoImagen plano_cpu = { roi_cpu, width, height, (size_t)width };
+            PlanoImagen plano_gpu = { roi_gpu, width, height, (size_t)width };
+
+            start = reloj_ms();
+            convolucion_roi(&plano_in, &plano_cpu, kernel_blur, k_size, regiones, num_regiones);
+            double roi_cpu_ms = reloj_ms() - start;
+
+            double roi_kernel_ms = 0.0;
+            convolucion_paralelo_roi(&mgr, &plano_in, &plano_gpu, kernel_blur, k_size,
+                                     regiones, num_regiones, &roi_kernel_ms);
+
+            // Dentro de cada región el resultado debe ser el de la imagen completa. La
+            // referencia es la convolución directa exacta (SIMD): cpu_result y gpu_result
+            // vienen del motor elegido, y FFT, caja o separable pueden diferir en ±1
+            convolucion_simd(img_data, referencia, width, height, kernel_blur, k_size);
+            long long distintos = 0;
+            for (int r = 0; r < num_regiones; r++) {
+                RegionROI rec;
+                if (!roi_recortar(&regiones[r], width, height, &rec)) continue;
+                for (int y = rec.y; y < rec.y + rec.height; y++) {
+                    for (int x = rec.x; x < rec.x + rec.width; x++) {
+                        size_t i = (size_t)y * width + x;
+                        distintos += (roi_cpu[i] != referencia[i]) + (roi_gpu[i] != referencia[i]);
+                    }
+                }
+            }
+            printf(">> CPU: %.4f ms, GPU (kernels): %.4f ms\n", roi_cpu_ms, roi_kernel_ms);
+            printf(">> Regiones %s a la imagen completa\n", distintos == 0 ? "identicas" : "DISTINTAS");
+            save_image("img_output/resultado_roi_cpu.png", width, height, 1, roi_cpu);
+            save_image("img_output/resultado_roi_gpu.png", width, height, 1, roi_gpu);
+        }
+        free(roi_cpu);
+        free(roi_gpu);
+        free(referencia);
+    }
 
 
     // --- FINALIZAR ---
     imprimir_titulo("LIMPIEZA Y SALIDA");
 
+    CLManager_PrintPoolStats(&mgr);
+    CLManager_FreeHost(&mgr, gpu_result);
+    CLManager_FreeHost(&mgr, img_data);
     CLManager_Cleanup(&mgr);
     free(cpu_result);
-    free(gpu_result);
-    free_image(img_data);
 
     printf("Programa finalizado correctamente.\n");
     return 0;
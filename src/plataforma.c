@@ -0,0 +1,23 @@
+#include "plataforma.h"
+
+#include <stdlib.h>
+#ifdef _WIN32
+#include <malloc.h>
+#endif
+
+void* reservar_alineado(size_t bytes, size_t alineacion) {
+#ifdef _WIN32
+    return _aligned_malloc(bytes, alineacion);
+#else
+    void* ptr = NULL;
+    return posix_memalign(&ptr, alineacion, bytes) == 0 ? ptr : NULL;
+#endif
+}
+
+void liberar_alineado(void* ptr) {
+#ifdef _WIN32
+    _aligned_free(ptr);
+#else
+    free(ptr);
+#endif
+}
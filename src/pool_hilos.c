@@ -0,0 +1,259 @@
+#include "pool_hilos.h"
+
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <unistd.h>
+#endif
+
+#define TAM_LINEA_CACHE 64
+
+// Rango de tareas pendientes de un hilo: [inicio, fin) empaquetado en 64 bits
+// (inicio en la parte baja) para mover ambos extremos con un solo compare-and-swap.
+// El relleno evita que dos colas compartan línea de caché (false sharing).
+typedef struct {
+    _Atomic uint64_t rango;
+    char relleno[TAM_LINEA_CACHE - sizeof(uint64_t)];
+} ColaTareas;
+
+typedef struct {
+    PoolHilos* pool;
+    int id;
+} ArgHilo;
+
+struct PoolHilos {
+    int num_hilos;                  // Incluye al hilo que llama a pool_ejecutar (id 0)
+    pthread_t* hilos;               // num_hilos - 1 trabajadores
+    ArgHilo* args;
+    ColaTareas* colas;              // Una por hilo
+
+    pthread_mutex_t mutex;
+    pthread_cond_t hay_trabajo;
+    pthread_cond_t trabajo_hecho;
+    unsigned long generacion;       // Se incrementa con cada trabajo nuevo
+    int pendientes;                 // Trabajadores que aún no terminan el trabajo actual
+    int terminar;
+
+    TareaPool funcion;
+    void* contexto;
+
+    pthread_mutex_t mutex_ejecutar; // Serializa llamadas concurrentes a pool_ejecutar
+};
+
+static uint64_t rango_empaquetar(uint32_t inicio, uint32_t fin) {
+    return ((uint64_t)fin << 32) | inicio;
+}
+
+// ============================================
+// 1. Consumo y robo de tareas
+// ============================================
+// El dueño toma tareas por el inicio de su rango...
+static int tomar_propia(ColaTareas* cola, int* tarea) {
+    uint64_t r = atomic_load(&cola->rango);
+    for (;;) {
+        uint32_t inicio = (uint32_t)r;
+        uint32_t fin = (uint32_t)(r >> 32);
+        if (inicio >= fin) return 0;
+
+        if (atomic_compare_exchange_weak(&cola->rango, &r, rango_empaquetar(inicio + 1, fin))) {
+            *tarea = (int)inicio;
+            return 1;
+        }
+    }
+}
+
+// ...y los ladrones se llevan la mitad final del rango de otro hilo
+static int robar(PoolHilos* pool, int id) {
+    for (int d = 1; d < pool->num_hilos; d++) {
+        ColaTareas* victima = &pool->colas[(id + d) % pool->num_hilos];
+        uint64_t r = atomic_load(&victima->rango);
+
+        for (;;) {
+            uint32_t inicio = (uint32_t)r;
+            uint32_t fin = (uint32_t)(r >> 32);
+            if (inicio >= fin) break;
+
+            uint32_t mitad = fin - (fin - inicio + 1) / 2;
+            if (atomic_compare_exchange_weak(&victima->rango, &r, rango_empaquetar(inicio, mitad))) {
+                // Nuestra cola está vacía: nadie más la modifica mientras la rellenamos
+                atomic_store(&pool->colas[id].rango, rango_empaquetar(mitad, fin));
+                return 1;
+            }
+        }
+    }
+    return 0;
+}
+
+static void trabajar(PoolHilos* pool, int id) {
+    int tarea;
+    for (;;) {
+        while (tomar_propia(&pool->colas[id], &tarea)) {
+            pool->funcion(pool->contexto, tarea);
+        }
+        if (!robar(pool, id)) return;
+    }
+}
+
+// ============================================
+// 2. Ciclo de vida de los hilos
+// ============================================
+static void* bucle_hilo(void* arg) {
+    ArgHilo* a = (ArgHilo*)arg;
+    PoolHilos* pool = a->pool;
+    unsigned long generacion_vista = 0;
+
+    pthread_mutex_lock(&pool->mutex);
+    for (;;) {
+        while (!pool->terminar && pool->generacion == generacion_vista) {
+            pthread_cond_wait(&pool->hay_trabajo, &pool->mutex);
+        }
+        if (pool->terminar) break;
+        generacion_vista = pool->generacion;
+        pthread_mutex_unlock(&pool->mutex);
+
+        trabajar(pool, a->id);
+
+        pthread_mutex_lock(&pool->mutex);
+        if (--pool->pendientes == 0) pthread_cond_signal(&pool->trabajo_hecho);
+    }
+    pthread_mutex_unlock(&pool->mutex);
+    return NULL;
+}
+
+int hilos_nucleos_disponibles(void) {
+#ifdef _WIN32
+    SYSTEM_INFO info;
+    GetSystemInfo(&info);
+    return (int)info.dwNumberOfProcessors;
+#else
+    long n = sysconf(_SC_NPROCESSORS_ONLN);
+    return n > 0 ? (int)n : 1;
+#endif
+}
+
+PoolHilos* pool_crear(int num_hilos) {
+    if (num_hilos <= 0) num_hilos = hilos_nucleos_disponibles();
+
+    PoolHilos* pool = (PoolHilos*)calloc(1, sizeof(PoolHilos));
+    if (!pool) return NULL;
+
+    pool->num_hilos = num_hilos;
+    pool->colas = (ColaTareas*)calloc(num_hilos, sizeof(ColaTareas));
+    pool->hilos = (pthread_t*)calloc(num_hilos, sizeof(pthread_t));
+    pool->args = (ArgHilo*)calloc(num_hilos, sizeof(ArgHilo));
+    if (!pool->colas || !pool->hilos || !pool->args) {
+        free(pool->colas);
+        free(pool->hilos);
+        free(pool->args);
+        free(pool);
+        return NULL;
+    }
+
+    pthread_mutex_init(&pool->mutex, NULL);
+    pthread_mutex_init(&pool->mutex_ejecutar, NULL);
+    pthread_cond_init(&pool->hay_trabajo, NULL);
+    pthread_cond_init(&pool->trabajo_hecho, NULL);
+
+    for (int i = 0; i < num_hilos; i++) {
+        atomic_init(&pool->colas[i].rango, 0);
+        pool->args[i].pool = pool;
+        pool->args[i].id = i;
+    }
+
+    // El hilo 0 es siempre el que llama a pool_ejecutar
+    for (int i = 1; i < num_hilos; i++) {
+        if (pthread_create(&pool->hilos[i], NULL, bucle_hilo, &pool->args[i]) != 0) {
+            // Seguimos con los hilos que sí se pudieron crear
+            pool->num_hilos = i;
+            break;
+        }
+    }
+    return pool;
+}
+
+static PoolHilos* pool_compartido = NULL;
+static pthread_once_t pool_compartido_once = PTHREAD_ONCE_INIT;
+
+static void pool_compartido_liberar(void) {
+    pool_destruir(pool_compartido);
+    pool_compartido = NULL;
+}
+
+static void pool_compartido_crear(void) {
+    // CONV_HILOS permite fijar el número de hilos (ej. para medir escalabilidad)
+    const char* env = getenv("CONV_HILOS");
+    pool_compartido = pool_crear(env ? atoi(env) : 0);
+    if (pool_compartido) atexit(pool_compartido_liberar);
+}
+
+PoolHilos* pool_global(void) {
+    pthread_once(&pool_compartido_once, pool_compartido_crear);
+    return pool_compartido;
+}
+
+int pool_num_hilos(const PoolHilos* pool) {
+    return pool->num_hilos;
+}
+
+// ============================================
+// 3. Ejecución de un trabajo
+// ============================================
+void pool_ejecutar(PoolHilos* pool, int num_tareas, TareaPool funcion, void* contexto) {
+    if (num_tareas <= 0) return;
+
+    pthread_mutex_lock(&pool->mutex_ejecutar);
+
+    // Reparto inicial: rangos contiguos del mismo tamaño (bandas vecinas en el mismo hilo)
+    for (int i = 0; i < pool->num_hilos; i++) {
+        uint32_t inicio = (uint32_t)((long long)num_tareas * i / pool->num_hilos);
+        uint32_t fin = (uint32_t)((long long)num_tareas * (i + 1) / pool->num_hilos);
+        atomic_store(&pool->colas[i].rango, rango_empaquetar(inicio, fin));
+    }
+
+    pthread_mutex_lock(&pool->mutex);
+    pool->funcion = funcion;
+    pool->contexto = contexto;
+    pool->pendientes = pool->num_hilos - 1;
+    pool->generacion++;
+    pthread_cond_broadcast(&pool->hay_trabajo);
+    pthread_mutex_unlock(&pool->mutex);
+
+    // El hilo que llama también trabaja
+    trabajar(pool, 0);
+
+    pthread_mutex_lock(&pool->mutex);
+    while (pool->pendientes > 0) {
+        pthread_cond_wait(&pool->trabajo_hecho, &pool->mutex);
+    }
+    pthread_mutex_unlock(&pool->mutex);
+
+    pthread_mutex_unlock(&pool->mutex_ejecutar);
+}
+
+void pool_destruir(PoolHilos* pool) {
+    if (!pool) return;
+
+    pthread_mutex_lock(&pool->mutex);
+    pool->terminar = 1;
+    pthread_cond_broadcast(&pool->hay_trabajo);
+    pthread_mutex_unlock(&pool->mutex);
+
+    for (int i = 1; i < pool->num_hilos; i++) {
+        pthread_join(pool->hilos[i], NULL);
+    }
+
+    pthread_mutex_destroy(&pool->mutex);
+    pthread_mutex_destroy(&pool->mutex_ejecutar);
+    pthread_cond_destroy(&pool->hay_trabajo);
+    pthread_cond_destroy(&pool->trabajo_hecho);
+
+    free(pool->colas);
+    free(pool->hilos);
+    free(pool->args);
+    free(pool);
+}
@@ -0,0 +1,37 @@
+#include "progreso.h"
+
+#include <stdio.h>
+
+void progreso_iniciar(Progreso* p, int total_filas) {
+    atomic_init(&p->filas_hechas, 0);
+    atomic_init(&p->ultimo_porcentaje, -1);
+    p->total_filas = total_filas > 0 ? total_filas : 1;
+}
+
+// Función auxiliar visual (Estilo Horizontal)
+void progreso_avanzar(Progreso* p, int filas) {
+    int hechas = atomic_fetch_add(&p->filas_hechas, filas) + filas;
+
+    // Calcular porcentaje (redondeado al 10% inferior)
+    int porcentaje = hechas * 100 / p->total_filas;
+    porcentaje -= porcentaje % 10;
+
+    // Solo el hilo que logra subir el contador imprime (no se repiten valores)
+    int anterior = atomic_load(&p->ultimo_porcentaje);
+    while (porcentaje > anterior) {
+        if (atomic_compare_exchange_weak(&p->ultimo_porcentaje, &anterior, porcentaje)) {
+            printf("%d%% ", porcentaje);
+            fflush(stdout);
+            break;
+        }
+    }
+}
+
+void progreso_finalizar(Progreso* p) {
+    // 3. Cierre estético
+    // Si el último no fue 100 (por redondeo), lo ponemos para cerrar bien
+    if (atomic_load(&p->ultimo_porcentaje) != 100) {
+        printf("100%%");
+    }
+    printf("\n"); // Ahora sí, salto de línea final
+}
@@ -0,0 +1,20 @@
+#include "reloj.h"
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <time.h>
+#endif
+
+double reloj_ms(void) {
+#ifdef _WIN32
+    LARGE_INTEGER frecuencia, contador;
+    QueryPerformanceFrequency(&frecuencia);
+    QueryPerformanceCounter(&contador);
+    return (double)contador.QuadPart * 1000.0 / (double)frecuencia.QuadPart;
+#else
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1000.0 + ts.tv_nsec / 1000000.0;
+#endif
+}
@@ -0,0 +1,180 @@
+#include "resultados.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+void tabla_iniciar(TablaBench* tabla) {
+    memset(tabla, 0, sizeof(*tabla));
+}
+
+void tabla_liberar(TablaBench* tabla) {
+    free(tabla->filas);
+    memset(tabla, 0, sizeof(*tabla));
+}
+
+int tabla_agregar(TablaBench* tabla, const char* motor, const char* fase, int width, int height,
+                  int k_size, const char* filtro, double* muestras, int n, double bytes) {
+    if (tabla->num_filas == tabla->capacidad) {
+        int capacidad = tabla->capacidad ? tabla->capacidad * 2 : 32;
+        FilaBench* filas = (FilaBench*)realloc(tabla->filas, sizeof(FilaBench) * capacidad);
+        if (!filas) return 0;
+        tabla->filas = filas;
+        tabla->capacidad = capacidad;
+    }
+
+    FilaBench* f = &tabla->filas[tabla->num_filas++];
+    snprintf(f->motor, sizeof(f->motor), "%s", motor);
+    snprintf(f->fase, sizeof(f->fase), "%s", fase);
+    snprintf(f->filtro, sizeof(f->filtro), "%s", filtro);
+    f->width = width;
+    f->height = height;
+    f->k_size = k_size;
+    f->bytes = bytes;
+    estadisticas_calcular(muestras, n, &f->e);
+    return 1;
+}
+
+double fila_mpx_s(const FilaBench* fila) {
+    return fila->e.mediana > 0.0 ? (double)fila->width * fila->height / (fila->e.mediana * 1000.0) : 0.0;
+}
+
+double fila_gb_s(const FilaBench* fila) {
+    return fila->e.mediana > 0.0 ? fila->bytes / (fila->e.mediana * 1.0e6) : 0.0;
+}
+
+void tabla_imprimir(const TablaBench* tabla) {
+    printf("%-11s %-7s %11s %4s %10s %10s %10s %9s %10s %8s\n",
+           "Motor", "Fase", "Imagen", "k", "Min (ms)", "Med (ms)", "p95 (ms)", "Desv", "Mpx/s", "GB/s");
+    for (int i = 0; i < tabla->num_filas; i++) {
+        const FilaBench* f = &tabla->filas[i];
+        char imagen[24];
+        snprintf(imagen, sizeof(imagen), "%dx%d", f->width, f->height);
+        printf("%-11s %-7s %11s %4d %10.3f %10.3f %10.3f %9.3f %10.1f %8.2f\n",
+               f->motor, f->fase, imagen, f->k_size, f->e.min, f->e.mediana, f->e.p95,
+               f->e.desviacion, fila_mpx_s(f), fila_gb_s(f));
+    }
+}
+
+int tabla_escribir_csv(const TablaBench* tabla, const char* ruta) {
+    FILE* archivo = fopen(ruta, "w");
+    if (!archivo) {
+        printf("Error: No se pudo escribir %s\n", ruta);
+        return 0;
+    }
+    fprintf(archivo, "motor,fase,ancho,alto,k,filtro,repeticiones,min_ms,mediana_ms,p95_ms,media_ms,desviacion_ms,mpx_s,gb_s\n");
+    for (int i = 0; i < tabla->num_filas; i++) {
+        const FilaBench* f = &tabla->filas[i];
+        fprintf(archivo, "%s,%s,%d,%d,%d,%s,%d,%.6f,%.6f,%.6f,%.6f,%.6f,%.3f,%.4f\n",
+                f->motor, f->fase, f->width, f->height, f->k_size, f->filtro, f->e.n,
+                f->e.min, f->e.mediana, f->e.p95, f->e.media, f->e.desviacion, fila_mpx_s(f), fila_gb_s(f));
+    }
+    fclose(archivo);
+    return 1;
+}
+
+// Cadena JSON entre comillas: escapa '"', '\\' y los caracteres de control
+static void json_escribir_texto(FILE* archivo, const char* texto) {
+    fputc('"', archivo);
+    for (const unsigned char* p = (const unsigned char*)texto; *p; p++) {
+        if (*p == '"' || *p == '\\') {
+            fputc('\\', archivo);
+            fputc(*p, archivo);
+        } else if (*p < 0x20) {
+            fprintf(archivo, "\\u%04x", *p);
+        } else {
+            fputc(*p, archivo);
+        }
+    }
+    fputc('"', archivo);
+}
+
+int tabla_escribir_json(const TablaBench* tabla, const char* ruta) {
+    FILE* archivo = fopen(ruta, "w");
+    if (!archivo) {
+        printf("Error: No se pudo escribir %s\n", ruta);
+        return 0;
+    }
+    fprintf(archivo, "{\"resultados\": [\n");
+    for (int i = 0; i < tabla->num_filas; i++) {
+        const FilaBench* f = &tabla->filas[i];
+        fprintf(archivo, "  {\"motor\": ");
+        json_escribir_texto(archivo, f->motor);
+        fprintf(archivo, ", \"fase\": ");
+        json_escribir_texto(archivo, f->fase);
+        fprintf(archivo, ", \"ancho\": %d, \"alto\": %d, \"k\": %d, \"filtro\": ", f->width, f->height, f->k_size);
+        json_escribir_texto(archivo, f->filtro);
+        fprintf(archivo,
+                ", \"repeticiones\": %d, \"min_ms\": %.6f, \"mediana_ms\": %.6f, \"p95_ms\": %.6f, \"media_ms\": %.6f, "
+                "\"desviacion_ms\": %.6f, \"mpx_s\": %.3f, \"gb_s\": %.4f}%s\n",
+                f->e.n, f->e.min, f->e.mediana, f->e.p95, f->e.media, f->e.desviacion, fila_mpx_s(f), fila_gb_s(f),
+                i + 1 < tabla->num_filas ? "," : "");
+    }
+    fprintf(archivo, "]}\n");
+    fclose(archivo);
+    return 1;
+}
+
+// Valor de "clave": ... en una línea JSON: el texto tras los dos puntos (NULL si no está)
+static const char* json_valor(const char* linea, const char* clave) {
+    char patron[40];
+    snprintf(patron, sizeof(patron), "\"%s\"", clave);
+    const char* p = strstr(linea, patron);
+    if (!p) return NULL;
+    p += strlen(patron);
+    while (*p == ' ' || *p == ':') p++;
+    return p;
+}
+
+// Cadena JSON de "clave" sin comillas; deshace los escapes \" y \\ de json_escribir_texto
+static void json_texto(const char* linea, const char* clave, char* destino, size_t max) {
+    const char* p = json_valor(linea, clave);
+    size_t n = 0;
+    if (p && *p == '"') {
+        for (p++; *p && *p != '"' && n + 1 < max; p++) {
+            if (*p == '\\' && p[1]) p++;
+            destino[n++] = *p;
+        }
+    }
+    destino[n] = '\0';
+}
+
+static double json_numero(const char* linea, const char* clave) {
+    const char* p = json_valor(linea, clave);
+    return p ? strtod(p, NULL) : 0.0;
+}
+
+int tabla_leer_json(TablaBench* tabla, const char* ruta) {
+    FILE* archivo = fopen(ruta, "r");
+    if (!archivo) {
+        printf("Error: No se pudo leer %s\n", ruta);
+        return -1;
+    }
+
+    char linea[1024];
+    int leidas = 0;
+    while (fgets(linea, sizeof(linea), archivo)) {
+        if (!json_valor(linea, "motor")) continue;
+
+        // Una muestra con la mediana; las estadísticas se copian del archivo
+        char motor[32], fase[16], filtro[16];
+        json_texto(linea, "motor", motor, sizeof(motor));
+        json_texto(linea, "fase", fase, sizeof(fase));
+        json_texto(linea, "filtro", filtro, sizeof(filtro));
+        double mediana = json_numero(linea, "mediana_ms");
+        if (!tabla_agregar(tabla, motor, fase, (int)json_numero(linea, "ancho"), (int)json_numero(linea, "alto"),
+                           (int)json_numero(linea, "k"), filtro, &mediana, 1, json_numero(linea, "gb_s") * mediana * 1.0e6)) {
+            break;
+        }
+
+        FilaBench* f = &tabla->filas[tabla->num_filas - 1];
+        f->e.n = (int)json_numero(linea, "repeticiones");
+        f->e.min = json_numero(linea, "min_ms");
+        f->e.p95 = json_numero(linea, "p95_ms");
+        f->e.media = json_numero(linea, "media_ms");
+        f->e.desviacion = json_numero(linea, "desviacion_ms");
+        leidas++;
+    }
+    fclose(archivo);
+    return leidas;
+}